@@ -0,0 +1,69 @@
+/**
+ * @file    Preferences.h
+ * @brief   NVS Preferences stand-in for the simulated hardware layer
+ *
+ * Same interface as the Arduino-ESP32 Preferences library, backed by an
+ * in-memory store that lives for the whole run (not across runs).
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_PREFERENCES_H
+#define SIM_PREFERENCES_H
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+
+class Preferences
+{
+public:
+    bool begin(const char *name, bool readOnly = false)
+    {
+        space = name;
+        this->readOnly = readOnly;
+        open = true;
+        return true;
+    }
+    void end() { open = false; }
+
+    bool isKey(const char *key) { return open && Store().count(Key(key)) != 0; }
+    bool remove(const char *key) { return open && !readOnly && Store().erase(Key(key)) != 0; }
+
+    size_t putFloat(const char *key, float value) { return Put(key, value, sizeof(float)); }
+    size_t putUInt(const char *key, uint32_t value) { return Put(key, value, sizeof(uint32_t)); }
+    size_t putBool(const char *key, bool value) { return Put(key, value ? 1 : 0, sizeof(uint8_t)); }
+
+    float getFloat(const char *key, float defaultValue = 0) { return (float)Get(key, defaultValue); }
+    uint32_t getUInt(const char *key, uint32_t defaultValue = 0) { return (uint32_t)Get(key, defaultValue); }
+    bool getBool(const char *key, bool defaultValue = false) { return Get(key, defaultValue ? 1 : 0) != 0; }
+
+private:
+    std::string space;
+    bool readOnly = false;
+    bool open = false;
+
+    static std::map<std::string, double> &Store()
+    {
+        static std::map<std::string, double> store;
+        return store;
+    }
+    std::string Key(const char *key) const { return space + "/" + key; }
+
+    size_t Put(const char *key, double value, size_t size)
+    {
+        if (!open || readOnly)
+            return 0;
+        Store()[Key(key)] = value;
+        return size;
+    }
+    double Get(const char *key, double defaultValue)
+    {
+        if (!open)
+            return defaultValue;
+        auto it = Store().find(Key(key));
+        return it == Store().end() ? defaultValue : it->second;
+    }
+};
+
+#endif // SIM_PREFERENCES_H
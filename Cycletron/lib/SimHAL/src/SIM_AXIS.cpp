@@ -0,0 +1,124 @@
+/**
+ * @file    SIM_AXIS.cpp
+ * @brief   Virtual DRV8825 axis with bumper switches
+ *
+ * Date:   Oct 2026
+ */
+
+#include <Arduino.h>
+#include "SIM_AXIS.h"
+#include "SIM_HAL.h"
+
+typedef struct
+{
+    SIM_AXIS_CONFIG_t config;
+    int32_t position;
+    int32_t phase;  ///< Indexer position within a full step, 0 = on one (power-up home state)
+    uint32_t lost;
+} SIM_AXIS_t;
+
+static SIM_AXIS_t axes[SIM_AXIS_COUNT];
+static int axisCount = 0;
+
+/**
+ * @brief Distance one STEP edge moves the carriage, from the MODE pins
+ *        (DRV8825 table: 0 = full step ... 5-7 = 1/32 step).
+ */
+static int32_t SIM_AXIS_Step_Size(const SIM_AXIS_CONFIG_t *c)
+{
+    int mode = (SIM_Get_Pin(c->mode0_pin) ? 1 : 0) |
+               (SIM_Get_Pin(c->mode1_pin) ? 2 : 0) |
+               (SIM_Get_Pin(c->mode2_pin) ? 4 : 0);
+    return (mode >= 5) ? 1 : (32 >> mode);
+}
+
+/**
+ * @brief Distance the indexer moves on one STEP edge: to the next valid
+ *        state of the current mode, so a short step if it sits between two.
+ */
+static int32_t SIM_AXIS_Indexer_Step(const SIM_AXIS_t *a, int32_t size, bool forward)
+{
+    int32_t offset = a->phase % size;
+    if (forward)
+        return size - offset;
+    return (offset != 0) ? offset : size;
+}
+
+/**
+ * @brief Updates both bumper switches from the carriage position.
+ */
+static void SIM_AXIS_Update_Bumpers(const SIM_AXIS_t *a)
+{
+    const SIM_AXIS_CONFIG_t *c = &a->config;
+    if (c->back_bumper_pin != SIM_AXIS_NO_PIN)
+        SIM_Set_Pin(c->back_bumper_pin, a->position <= c->back_bumper ? HIGH : LOW);
+    if (c->front_bumper_pin != SIM_AXIS_NO_PIN)
+        SIM_Set_Pin(c->front_bumper_pin, a->position >= c->front_bumper ? HIGH : LOW);
+}
+
+/**
+ * @brief Pin write observer: one rising STEP edge with ENABLE low moves
+ *        the carriage one step in the DIR direction.
+ */
+static void SIM_AXIS_On_Pin(int pin, int level, void *context)
+{
+    (void)context;
+    if (level != HIGH)
+        return;
+
+    for (int i = 0; i < axisCount; i++)
+    {
+        SIM_AXIS_t *a = &axes[i];
+        const SIM_AXIS_CONFIG_t *c = &a->config;
+        if (pin != c->step_pin || SIM_Get_Pin(c->enable_pin) != LOW)
+            continue;
+
+        bool forward = SIM_Get_Pin(c->dir_pin);
+        int32_t step = SIM_AXIS_Indexer_Step(a, SIM_AXIS_Step_Size(c), forward);
+        int32_t target = a->position + (forward ? step : -step);
+        int32_t minimum = c->back_bumper - c->hard_stop;
+        int32_t maximum = c->front_bumper + c->hard_stop;
+        a->phase = (a->phase + (forward ? step : 32 - step)) % 32; // The indexer advances even if the rotor stalls
+        if (target < minimum || target > maximum)
+        {
+            a->lost += (uint32_t)step;
+            return;
+        }
+        a->position = target;
+        SIM_AXIS_Update_Bumpers(a);
+        return;
+    }
+}
+
+int SIM_AXIS_Add(const SIM_AXIS_CONFIG_t *config)
+{
+    if (axisCount >= SIM_AXIS_COUNT)
+        return -1;
+    if (axisCount == 0 && !SIM_Add_Pin_Hook(SIM_AXIS_On_Pin, NULL))
+        return -1;
+
+    SIM_AXIS_t *a = &axes[axisCount];
+    a->config = *config;
+    a->position = config->start_position;
+    a->phase = 0;
+    a->lost = 0;
+    SIM_Set_Pin(config->fault_pin, HIGH);
+    SIM_AXIS_Update_Bumpers(a);
+    return axisCount++;
+}
+
+int32_t SIM_AXIS_Position(int axis)
+{
+    return (axis >= 0 && axis < axisCount) ? axes[axis].position : 0;
+}
+
+uint32_t SIM_AXIS_Lost_Steps(int axis)
+{
+    return (axis >= 0 && axis < axisCount) ? axes[axis].lost : 0;
+}
+
+void SIM_AXIS_Inject_Fault(int axis, bool fault)
+{
+    if (axis >= 0 && axis < axisCount)
+        SIM_Set_Pin(axes[axis].config.fault_pin, fault ? LOW : HIGH);
+}
@@ -0,0 +1,71 @@
+/**
+ * @file    SIM_AXIS.h
+ * @brief   Virtual DRV8825 axis with bumper switches (native builds only)
+ *
+ * Watches the firmware's writes to a driver's STEP/DIR/MODE/ENABLE pins and
+ * integrates them into a carriage position, in the same 1/32-step units as
+ * MOTION.h. Like the DRV8825 indexer, a STEP edge only goes as far as the
+ * next valid state of the current mode, so after a mode change the first
+ * step can be short. Bumper switches close (pin HIGH, so RISING interrupts fire) when
+ * the carriage reaches them, and the carriage cannot move past a hard stop
+ * just beyond each bumper: steps into the stop are lost, like a stalled
+ * motor.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_AXIS_H
+#define SIM_AXIS_H
+
+#include <stdint.h>
+
+#define SIM_AXIS_COUNT 4 // Simulated drivers
+#define SIM_AXIS_NO_PIN -1
+
+/**
+ * @struct SIM_AXIS_CONFIG_t
+ * @brief  Wiring and mechanics of one axis. Positions in 1/32 steps,
+ *         increasing in the DIR HIGH (DRV8825_FORWARD) direction.
+ */
+typedef struct
+{
+    const char *name;
+    int step_pin;
+    int dir_pin;
+    int fault_pin;
+    int mode0_pin;
+    int mode1_pin;
+    int mode2_pin;
+    int enable_pin;
+
+    int back_bumper_pin;     ///< SIM_AXIS_NO_PIN if the axis has none
+    int32_t back_bumper;     ///< Switch closes at or below this position
+    int front_bumper_pin;    ///< SIM_AXIS_NO_PIN if the axis has none
+    int32_t front_bumper;    ///< Switch closes at or above this position
+    int32_t hard_stop;       ///< Travel allowed past a bumper before the stop
+    int32_t start_position;  ///< Position at power-up
+} SIM_AXIS_CONFIG_t;
+
+/**
+ * @brief Adds an axis; its FAULT line starts healthy (HIGH).
+ *
+ * @return Axis index, or -1 if all SIM_AXIS_COUNT slots are taken
+ */
+int SIM_AXIS_Add(const SIM_AXIS_CONFIG_t *config);
+
+/**
+ * @brief Current carriage position in 1/32 steps.
+ */
+int32_t SIM_AXIS_Position(int axis);
+
+/**
+ * @brief Steps the driver accepted but the hard stops swallowed (1/32 steps).
+ */
+uint32_t SIM_AXIS_Lost_Steps(int axis);
+
+/**
+ * @brief Pulls the axis's FAULT line LOW (true) or releases it (false).
+ */
+void SIM_AXIS_Inject_Fault(int axis, bool fault);
+
+#endif // SIM_AXIS_H
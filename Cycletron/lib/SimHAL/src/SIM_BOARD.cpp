@@ -0,0 +1,67 @@
+/**
+ * @file    SIM_BOARD.cpp
+ * @brief   Simulated Cycletron board wiring
+ *
+ * The carriage powers up part way along its rail so homing has to travel
+ * to the back bumper; the syringe starts just clear of its back bumper.
+ *
+ * Date:   Oct 2026
+ */
+
+#include <Arduino.h>
+#include "SIM_BOARD.h"
+#include "SIM_HAL.h"
+
+int simCarriageAxis = -1;
+int simSyringeAxis = -1;
+
+// Carriage (MOVEMENT.cpp)
+static const SIM_AXIS_CONFIG_t carriageAxis = {
+    .name = "carriage",
+    .step_pin = 6,
+    .dir_pin = 7,
+    .fault_pin = 15,
+    .mode0_pin = 16,
+    .mode1_pin = 17,
+    .mode2_pin = 18,
+    .enable_pin = 8,
+    .back_bumper_pin = 10,
+    .back_bumper = 0,
+    .front_bumper_pin = 3,
+    .front_bumper = SIM_BOARD_CARRIAGE_TRAVEL,
+    .hard_stop = SIM_BOARD_HARD_STOP,
+    .start_position = SIM_BOARD_CARRIAGE_TRAVEL / 3};
+
+// Syringe (REHYDRATION.cpp)
+static const SIM_AXIS_CONFIG_t syringeAxis = {
+    .name = "syringe",
+    .step_pin = 1,
+    .dir_pin = 2,
+    .fault_pin = 42,
+    .mode0_pin = 41,
+    .mode1_pin = 40,
+    .mode2_pin = 39,
+    .enable_pin = 38,
+    .back_bumper_pin = 9,
+    .back_bumper = 0,
+    .front_bumper_pin = 46,
+    .front_bumper = SIM_BOARD_SYRINGE_TRAVEL,
+    .hard_stop = SIM_BOARD_HARD_STOP,
+    .start_position = 10 * 32};
+
+// Heater pad (HEATING.cpp)
+static const SIM_THERMAL_CONFIG_t heaterPlant = {
+    .heater_pin = 5,
+    .thermistor_pin = 4,
+    .ambient_c = 22.0f,
+    .full_power_rise = 100.0f,
+    .tau_s = 600.0f,
+    .sensor_tau_s = 30.0f,
+    .noise_mv = 2};
+
+void SIM_Board_Init(void)
+{
+    simCarriageAxis = SIM_AXIS_Add(&carriageAxis);
+    simSyringeAxis = SIM_AXIS_Add(&syringeAxis);
+    SIM_THERMAL_Init(&heaterPlant);
+}
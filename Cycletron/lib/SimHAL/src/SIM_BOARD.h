@@ -0,0 +1,28 @@
+/**
+ * @file    SIM_BOARD.h
+ * @brief   Simulated Cycletron board: axes, bumpers and heater plant
+ *
+ * Wiring mirrors MOVEMENT.cpp, REHYDRATION.cpp and HEATING.cpp. Harnesses
+ * use the axis indices below with SIM_AXIS.h.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_BOARD_H
+#define SIM_BOARD_H
+
+#include "SIM_AXIS.h"
+#include "SIM_THERMAL.h"
+
+// === Mechanics (1/32 steps) ===
+#define SIM_BOARD_CARRIAGE_TRAVEL (4000 * 32)        // Bumper to bumper, 4000 full steps
+#define SIM_BOARD_SYRINGE_TRAVEL (159251 * 2)        // MAX_SYRINGE_STEPS at 1/16 step
+#define SIM_BOARD_HARD_STOP (2 * 32)                 // Switch overtravel before the stop
+
+/**
+ * @brief Axis indices assigned by SIM_Board_Init().
+ */
+extern int simCarriageAxis;
+extern int simSyringeAxis;
+
+#endif // SIM_BOARD_H
@@ -0,0 +1,758 @@
+/**
+ * @file    SIM_HAL.cpp
+ * @brief   Simulated hardware layer: virtual clock, timers, GPIO, ADC, I/O
+ *
+ * A single-threaded event loop stands in for the chip. Foreground code
+ * moves the virtual clock forward (delay(), yield(), clock reads); while it
+ * moves, every hardware timer alarm that falls due is fired in time order
+ * and its ISR is run right there, before the foreground continues. Pin
+ * edges from SIM_Set_Pin() run their interrupt handlers immediately.
+ * FreeRTOS tasks (SIM_RTOS.cpp) are scheduled from the same loop.
+ *
+ * Date:   Oct 2026
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_timer.h>
+#include <deque>
+#include <string>
+#include "SIM_HAL.h"
+
+// === Virtual Clock ===
+#define SIM_DEFAULT_YIELD_NS 100000ULL // One yield() = 100 us
+#define SIM_CLOCK_READ_NS 50ULL        // millis()/micros() cost, so polling loops make progress
+
+static uint64_t nowNs = 0;
+static uint64_t yieldNs = SIM_DEFAULT_YIELD_NS;
+static int isrDepth = 0; // > 0 while an interrupt handler runs
+
+// === Interrupt Latency Model ===
+static uint32_t latencyMaxNs = 0;
+static uint8_t latencyPercent = 0;
+static uint32_t latencySeed = 0x2545F491;
+
+// === Hardware Timers ===
+struct hw_timer_s
+{
+    bool used;
+    uint16_t divider;         ///< Prescaler on the APB clock
+    uint64_t baseNs;          ///< Virtual time at which the counter was 0
+    uint64_t alarm;           ///< Alarm value in timer ticks
+    bool autoreload;          ///< Counter restarts from 0 at the alarm
+    bool alarmEnabled;
+    void (*isr)(void);
+};
+
+static hw_timer_s timers[SIM_TIMER_COUNT];
+
+// === Plant Models ===
+static struct
+{
+    SIM_PERIODIC_t update;
+    void *context;
+    uint64_t periodNs;
+    uint64_t nextNs;
+} periodics[SIM_PERIODIC_COUNT];
+
+// === GPIO ===
+typedef struct
+{
+    uint8_t level;
+    uint8_t mode;
+    bool driven;              ///< Level set from outside with SIM_Set_Pin()
+    int analogMv;
+    int edgeMode;             ///< RISING / FALLING / CHANGE, 0 = no interrupt
+    void (*isr)(void);
+    void (*isrArg)(void *);
+    void *arg;
+    int ledc;                 ///< Attached LEDC channel + 1, 0 = plain GPIO
+} SIM_Pin_t;
+
+static SIM_Pin_t pins[SIM_PIN_COUNT];
+
+// === LEDC ===
+static struct
+{
+    uint8_t bits;
+    uint32_t duty;
+} ledcChannels[SIM_LEDC_COUNT];
+
+static struct
+{
+    SIM_PIN_HOOK_t hook;
+    void *context;
+} pinHooks[SIM_PIN_HOOK_COUNT];
+
+// === WebSocket / Serial / Run State ===
+static SIM_WS_HOOK_t wsHook = NULL;
+static void *wsHookContext = NULL;
+static SIM_WS_HOOK_t wsReceiver = NULL;
+static void *wsReceiverContext = NULL;
+static std::deque<std::string> wsInbox; // Frames waiting for webSocket.loop()
+
+static bool serialEcho = true;
+static std::string serialInput;
+
+static bool finished = false;
+static int exitCode = 0;
+static uint64_t timeLimitNs = 0;
+
+HardwareSerial Serial;
+HardwareSerial Serial0;
+EspClass ESP;
+WiFiClass WiFi;
+
+// ---------------------------------------------------------------------------
+// Virtual time
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Converts timer ticks to nanoseconds for a timer's prescaler.
+ */
+static uint64_t SIM_Ticks_To_Ns(const hw_timer_s *timer, uint64_t ticks)
+{
+    return ticks * timer->divider * 1000ULL / SIM_APB_MHZ;
+}
+
+/**
+ * @brief Latency added before the next timer ISR (xorshift32, repeatable).
+ */
+static uint64_t SIM_Draw_Latency(void)
+{
+    if (latencyMaxNs == 0 || latencyPercent == 0)
+        return 0;
+
+    latencySeed ^= latencySeed << 13;
+    latencySeed ^= latencySeed >> 17;
+    latencySeed ^= latencySeed << 5;
+    if (latencySeed % 100 >= latencyPercent)
+        return 0;
+    return (latencySeed >> 8) % latencyMaxNs;
+}
+
+/**
+ * @brief Finds the timer whose alarm comes first.
+ *
+ * @return Timer index, or -1 if no alarm is armed
+ */
+static int SIM_Next_Alarm(uint64_t *when)
+{
+    int next = -1;
+    for (int i = 0; i < SIM_TIMER_COUNT; i++)
+    {
+        const hw_timer_s *timer = &timers[i];
+        if (!timer->used || !timer->alarmEnabled)
+            continue;
+
+        uint64_t ticks = timer->alarm > 0 ? timer->alarm : 1; // A zero alarm would fire forever
+        uint64_t fire = timer->baseNs + SIM_Ticks_To_Ns(timer, ticks);
+        if (next < 0 || fire < *when)
+        {
+            next = i;
+            *when = fire;
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief Runs an interrupt handler the way the chip would: foreground suspended.
+ */
+static void SIM_Run_ISR(void (*isr)(void), void (*isrArg)(void *), void *arg)
+{
+    isrDepth++;
+    if (isr)
+        isr();
+    else if (isrArg)
+        isrArg(arg);
+    isrDepth--;
+}
+
+/**
+ * @brief Finds the plant model update that comes first.
+ *
+ * @return Slot index, or -1 if none is registered
+ */
+static int SIM_Next_Periodic(uint64_t *when)
+{
+    int next = -1;
+    for (int i = 0; i < SIM_PERIODIC_COUNT; i++)
+    {
+        if (periodics[i].update && (next < 0 || periodics[i].nextNs < *when))
+        {
+            next = i;
+            *when = periodics[i].nextNs;
+        }
+    }
+    return next;
+}
+
+bool SIM_Advance_Step(uint64_t target)
+{
+    // Time passing inside an ISR (delayMicroseconds) cannot fire other alarms
+    if (isrDepth > 0)
+    {
+        if (target > nowNs)
+            nowNs = target;
+        return false;
+    }
+
+    uint64_t fire = 0;
+    uint64_t update = 0;
+    int index = SIM_Next_Alarm(&fire);
+    int model = SIM_Next_Periodic(&update);
+    uint64_t wake = 0;
+    bool task = SIM_Task_Next_Wake(&wake); // Never while a task runs: it holds the CPU
+
+    if (model >= 0 && update <= target && (index < 0 || update < fire) && (!task || update <= wake))
+    {
+        if (update > nowNs)
+            nowNs = update;
+        periodics[model].nextNs += periodics[model].periodNs;
+        periodics[model].update(nowNs, periodics[model].context);
+        return true;
+    }
+    if (index < 0 || fire > target || (task && wake < fire))
+    {
+        // FreeRTOS tasks run after the alarms and model updates due at the same time
+        if (!task || wake > target)
+        {
+            if (target > nowNs)
+                nowNs = target;
+            return false;
+        }
+        if (wake > nowNs)
+            nowNs = wake;
+        SIM_Task_Run_Next();
+        return true;
+    }
+
+    hw_timer_s *timer = &timers[index];
+    if (fire > nowNs)
+        nowNs = fire;
+
+    // The counter reloads in hardware at the alarm, however late the ISR runs
+    if (timer->autoreload)
+        timer->baseNs = fire;
+    else
+        timer->alarmEnabled = false;
+
+    nowNs += SIM_Draw_Latency();
+    SIM_Run_ISR(timer->isr, NULL, NULL);
+    return true;
+}
+
+/**
+ * @brief Moves the clock to `target`, firing every alarm and model update
+ *        due on the way and running the tasks that wake, in time order.
+ */
+static void SIM_Advance_To(uint64_t target)
+{
+    while (SIM_Advance_Step(target))
+    {
+    }
+}
+
+uint64_t SIM_Now_Ns(void)
+{
+    return nowNs;
+}
+
+void SIM_Advance_Ns(uint64_t ns)
+{
+    SIM_Advance_To(nowNs + ns);
+}
+
+void SIM_Advance_Us(uint64_t us)
+{
+    SIM_Advance_Ns(us * 1000ULL);
+}
+
+uint32_t SIM_Cycle_Count(void)
+{
+    return (uint32_t)(nowNs * SIM_CPU_MHZ / 1000ULL);
+}
+
+void SIM_Set_Yield_Us(uint32_t us)
+{
+    yieldNs = (uint64_t)us * 1000ULL;
+}
+
+bool SIM_Add_Periodic(SIM_PERIODIC_t update, void *context, uint32_t period_us)
+{
+    for (int i = 0; i < SIM_PERIODIC_COUNT; i++)
+    {
+        if (periodics[i].update == NULL)
+        {
+            periodics[i].update = update;
+            periodics[i].context = context;
+            periodics[i].periodNs = (uint64_t)(period_us ? period_us : 1) * 1000ULL;
+            periodics[i].nextNs = nowNs + periodics[i].periodNs;
+            return true;
+        }
+    }
+    return false;
+}
+
+void SIM_Set_ISR_Latency(uint32_t max_ns, uint8_t percent)
+{
+    latencyMaxNs = max_ns;
+    latencyPercent = percent > 100 ? 100 : percent;
+}
+
+unsigned long millis(void)
+{
+    SIM_Advance_Ns(SIM_CLOCK_READ_NS);
+    return (unsigned long)(nowNs / 1000000ULL);
+}
+
+unsigned long micros(void)
+{
+    SIM_Advance_Ns(SIM_CLOCK_READ_NS);
+    return (unsigned long)(nowNs / 1000ULL);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)(nowNs / 1000ULL);
+}
+
+void delay(uint32_t ms)
+{
+    // As in the ESP32 core, delay() in a task blocks it and lets the others run
+    if (SIM_Task_Running())
+    {
+        vTaskDelay(pdMS_TO_TICKS(ms));
+        return;
+    }
+    SIM_Advance_Ns((uint64_t)ms * 1000000ULL);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    SIM_Advance_Ns((uint64_t)us * 1000ULL);
+}
+
+void yield(void)
+{
+    SIM_Advance_Ns(yieldNs);
+}
+
+uint32_t getCpuFrequencyMhz(void)
+{
+    return SIM_CPU_MHZ;
+}
+
+// ---------------------------------------------------------------------------
+// Hardware timers
+// ---------------------------------------------------------------------------
+
+hw_timer_t *timerBegin(uint8_t num, uint16_t divider, bool countUp)
+{
+    (void)countUp;
+    if (num >= SIM_TIMER_COUNT)
+        return NULL;
+
+    hw_timer_s *timer = &timers[num];
+    timer->used = true;
+    timer->divider = divider ? divider : 1;
+    timer->baseNs = nowNs;
+    timer->alarm = 0;
+    timer->autoreload = false;
+    timer->alarmEnabled = false;
+    timer->isr = NULL;
+    return timer;
+}
+
+void timerEnd(hw_timer_t *timer)
+{
+    if (timer)
+        timer->used = false;
+}
+
+void timerAttachInterrupt(hw_timer_t *timer, void (*isr)(void), bool edge)
+{
+    (void)edge;
+    if (timer)
+        timer->isr = isr;
+}
+
+void timerDetachInterrupt(hw_timer_t *timer)
+{
+    if (timer)
+        timer->isr = NULL;
+}
+
+void timerAlarmWrite(hw_timer_t *timer, uint64_t alarmValue, bool autoreload)
+{
+    if (!timer)
+        return;
+    timer->alarm = alarmValue;
+    timer->autoreload = autoreload;
+}
+
+void timerAlarmEnable(hw_timer_t *timer)
+{
+    if (timer)
+        timer->alarmEnabled = true;
+}
+
+void timerAlarmDisable(hw_timer_t *timer)
+{
+    if (timer)
+        timer->alarmEnabled = false;
+}
+
+void timerWrite(hw_timer_t *timer, uint64_t value)
+{
+    if (timer)
+        timer->baseNs = nowNs - SIM_Ticks_To_Ns(timer, value);
+}
+
+uint64_t timerRead(hw_timer_t *timer)
+{
+    if (!timer)
+        return 0;
+    return (nowNs - timer->baseNs) * SIM_APB_MHZ / (1000ULL * timer->divider);
+}
+
+// ---------------------------------------------------------------------------
+// GPIO
+// ---------------------------------------------------------------------------
+
+static bool SIM_Valid_Pin(int pin)
+{
+    return pin >= 0 && pin < SIM_PIN_COUNT;
+}
+
+/**
+ * @brief Applies a new level and runs the pin's interrupt on a matching edge.
+ */
+static void SIM_Change_Level(int pin, int level)
+{
+    SIM_Pin_t *p = &pins[pin];
+    level = level ? HIGH : LOW;
+    if (p->level == level)
+        return;
+    p->level = (uint8_t)level;
+
+    bool match = (p->edgeMode == CHANGE) ||
+                 (p->edgeMode == RISING && level == HIGH) ||
+                 (p->edgeMode == FALLING && level == LOW);
+    if (match)
+        SIM_Run_ISR(p->isr, p->isrArg, p->arg);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (!SIM_Valid_Pin(pin))
+        return;
+
+    SIM_Pin_t *p = &pins[pin];
+    p->mode = mode;
+    if (!p->driven && mode == INPUT_PULLUP)
+        p->level = HIGH;
+    else if (!p->driven && mode == INPUT_PULLDOWN)
+        p->level = LOW;
+}
+
+void SIM_Write_Pin(int pin, int level)
+{
+    if (!SIM_Valid_Pin(pin))
+        return;
+
+    level = level ? HIGH : LOW;
+    if (pins[pin].level == level)
+        return;
+
+    SIM_Change_Level(pin, level);
+    for (int i = 0; i < SIM_PIN_HOOK_COUNT; i++)
+    {
+        if (pinHooks[i].hook)
+            pinHooks[i].hook(pin, level, pinHooks[i].context);
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+    SIM_Write_Pin(pin, level);
+}
+
+int digitalRead(uint8_t pin)
+{
+    return SIM_Valid_Pin(pin) ? pins[pin].level : LOW;
+}
+
+void SIM_Set_Pin(int pin, int level)
+{
+    if (!SIM_Valid_Pin(pin))
+        return;
+    pins[pin].driven = true;
+    SIM_Change_Level(pin, level);
+}
+
+int SIM_Get_Pin(int pin)
+{
+    return SIM_Valid_Pin(pin) ? pins[pin].level : LOW;
+}
+
+bool SIM_Add_Pin_Hook(SIM_PIN_HOOK_t hook, void *context)
+{
+    for (int i = 0; i < SIM_PIN_HOOK_COUNT; i++)
+    {
+        if (pinHooks[i].hook == NULL)
+        {
+            pinHooks[i].hook = hook;
+            pinHooks[i].context = context;
+            return true;
+        }
+    }
+    return false;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode)
+{
+    if (!SIM_Valid_Pin(pin))
+        return;
+    pins[pin].isr = isr;
+    pins[pin].isrArg = NULL;
+    pins[pin].arg = NULL;
+    pins[pin].edgeMode = mode;
+}
+
+void attachInterruptArg(uint8_t pin, void (*isr)(void *), void *arg, int mode)
+{
+    if (!SIM_Valid_Pin(pin))
+        return;
+    pins[pin].isr = NULL;
+    pins[pin].isrArg = isr;
+    pins[pin].arg = arg;
+    pins[pin].edgeMode = mode;
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    if (SIM_Valid_Pin(pin))
+        pins[pin].edgeMode = 0;
+}
+
+// ---------------------------------------------------------------------------
+// ADC
+// ---------------------------------------------------------------------------
+
+void SIM_Set_Analog_MV(int pin, int millivolts)
+{
+    if (SIM_Valid_Pin(pin))
+        pins[pin].analogMv = millivolts;
+}
+
+int SIM_Get_Analog_MV(int pin)
+{
+    return SIM_Valid_Pin(pin) ? pins[pin].analogMv : 0;
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin)
+{
+    int mv = SIM_Get_Analog_MV(pin);
+    return mv < 0 ? 0 : (uint32_t)mv;
+}
+
+uint16_t analogRead(uint8_t pin)
+{
+    uint32_t raw = analogReadMilliVolts(pin) * 4095UL / 3300UL; // 12 bit, 11 dB range
+    return (uint16_t)(raw > 4095 ? 4095 : raw);
+}
+
+void analogReadResolution(uint8_t bits)
+{
+    (void)bits;
+}
+
+void analogSetAttenuation(adc_attenuation_t attenuation)
+{
+    (void)attenuation;
+}
+
+// ---------------------------------------------------------------------------
+// LEDC
+// ---------------------------------------------------------------------------
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolution_bits)
+{
+    if (channel >= SIM_LEDC_COUNT || resolution_bits == 0 || resolution_bits > 20)
+        return 0;
+    ledcChannels[channel].bits = resolution_bits;
+    ledcChannels[channel].duty = 0;
+    return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel)
+{
+    if (SIM_Valid_Pin(pin) && channel < SIM_LEDC_COUNT)
+        pins[pin].ledc = channel + 1;
+}
+
+void ledcDetachPin(uint8_t pin)
+{
+    if (SIM_Valid_Pin(pin))
+        pins[pin].ledc = 0;
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty)
+{
+    if (channel >= SIM_LEDC_COUNT)
+        return;
+    ledcChannels[channel].duty = duty;
+
+    // Level of attached pins: HIGH whenever the output is not fully off
+    for (int pin = 0; pin < SIM_PIN_COUNT; pin++)
+    {
+        if (pins[pin].ledc == channel + 1)
+            SIM_Write_Pin(pin, duty ? HIGH : LOW);
+    }
+}
+
+uint32_t ledcRead(uint8_t channel)
+{
+    return channel < SIM_LEDC_COUNT ? ledcChannels[channel].duty : 0;
+}
+
+float SIM_Get_Pin_Duty(int pin)
+{
+    if (!SIM_Valid_Pin(pin))
+        return 0;
+    if (pins[pin].ledc == 0)
+        return pins[pin].level ? 1.0f : 0.0f;
+
+    int channel = pins[pin].ledc - 1;
+    uint32_t full = 1UL << ledcChannels[channel].bits;
+    uint32_t duty = ledcChannels[channel].duty;
+    return duty >= full - 1 ? 1.0f : (float)duty / (float)full; // Full-scale duty is always on
+}
+
+// ---------------------------------------------------------------------------
+// WebSocket
+// ---------------------------------------------------------------------------
+
+void SIM_Set_WebSocket_Hook(SIM_WS_HOOK_t hook, void *context)
+{
+    wsHook = hook;
+    wsHookContext = context;
+}
+
+void SIM_WebSocket_Set_Receiver(SIM_WS_HOOK_t receiver, void *context)
+{
+    wsReceiver = receiver;
+    wsReceiverContext = context;
+}
+
+void SIM_WebSocket_Send(const char *text, size_t length)
+{
+    if (wsHook)
+        wsHook(text, length, wsHookContext);
+}
+
+void SIM_WebSocket_Receive(const char *text)
+{
+    wsInbox.push_back(text);
+}
+
+void SIM_WebSocket_Poll(void)
+{
+    while (wsReceiver && !wsInbox.empty())
+    {
+        std::string frame = wsInbox.front(); // The handler may parse in place
+        wsInbox.pop_front();
+        wsReceiver(&frame[0], frame.length(), wsReceiverContext);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Serial / chip
+// ---------------------------------------------------------------------------
+
+void SIM_Set_Serial_Echo(bool echo)
+{
+    serialEcho = echo;
+}
+
+void SIM_Serial_Input(const char *text)
+{
+    serialInput += text;
+}
+
+int HardwareSerial::available()
+{
+    return (int)serialInput.length();
+}
+
+int HardwareSerial::read()
+{
+    if (serialInput.empty())
+        return -1;
+    int c = (unsigned char)serialInput[0];
+    serialInput.erase(0, 1);
+    return c;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    if (serialEcho)
+        fputc(c, stdout);
+    return 1;
+}
+
+size_t HardwareSerial::write(const char *text)
+{
+    if (!text)
+        return 0;
+    if (serialEcho)
+        fputs(text, stdout);
+    return strlen(text);
+}
+
+size_t HardwareSerial::printf(const char *format, ...)
+{
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    write(buffer);
+    return n < 0 ? 0 : (size_t)n;
+}
+
+void EspClass::restart()
+{
+    Serial.println("[SIM] ESP.restart() requested, ending run");
+    SIM_Finish(0);
+}
+
+// ---------------------------------------------------------------------------
+// Run control
+// ---------------------------------------------------------------------------
+
+void SIM_Finish(int code)
+{
+    if (!finished)
+        exitCode = code;
+    finished = true;
+}
+
+bool SIM_Is_Finished(void)
+{
+    if (timeLimitNs && nowNs >= timeLimitNs)
+        finished = true;
+    return finished;
+}
+
+int SIM_Exit_Code(void)
+{
+    return exitCode;
+}
+
+void SIM_Set_Time_Limit(uint32_t seconds)
+{
+    timeLimitNs = (uint64_t)seconds * 1000000000ULL;
+}
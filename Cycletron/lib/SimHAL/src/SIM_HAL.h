@@ -0,0 +1,270 @@
+/**
+ * @file    SIM_HAL.h
+ * @brief   Control side of the simulated hardware layer (native builds only)
+ *
+ * The firmware sees an ordinary Arduino API (see Arduino.h in this library).
+ * Everything behind it runs on a virtual clock: delay(), yield() and the
+ * millis()/micros() readers advance it, and hardware timer alarms fire as
+ * "interrupts" at their exact virtual time while it advances. Nothing ever
+ * waits for real time, so long runs finish as fast as the host can execute
+ * them.
+ *
+ * This header is what host-side harnesses use to drive the outside world:
+ * inputs, interrupt latency, observing pin writes, and ending the run.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// === Simulated Hardware Sizes ===
+#define SIM_PIN_COUNT 64        // GPIO numbers 0..63
+#define SIM_TIMER_COUNT 4       // Hardware timers
+#define SIM_PIN_HOOK_COUNT 8    // Observers of firmware pin writes
+#define SIM_PERIODIC_COUNT 8    // Plant models stepped on the virtual clock
+#define SIM_LEDC_COUNT 8        // LEDC PWM channels
+#define SIM_CPU_MHZ 240         // Cycle counter rate
+#define SIM_APB_MHZ 80          // Timer input clock
+
+// === Virtual Time ===
+
+/**
+ * @brief Current virtual time in nanoseconds since start.
+ */
+uint64_t SIM_Now_Ns(void);
+
+/**
+ * @brief Advances virtual time, running every timer alarm that falls due.
+ *
+ * @param ns Nanoseconds to advance
+ */
+void SIM_Advance_Ns(uint64_t ns);
+
+/**
+ * @brief SIM_Advance_Ns() in microseconds.
+ */
+void SIM_Advance_Us(uint64_t us);
+
+/**
+ * @brief CPU cycle counter at SIM_CPU_MHZ, wrapping like the Xtensa CCOUNT.
+ */
+uint32_t SIM_Cycle_Count(void);
+
+/**
+ * @brief Sets how far one yield() moves the clock.
+ *
+ * Busy-wait loops (DRV8825_Wait(), MOTION_Wait()) call yield(), so this is
+ * the granularity of foreground code; interrupts always fire on time.
+ *
+ * @param us Microseconds per yield(), default 100
+ */
+void SIM_Set_Yield_Us(uint32_t us);
+
+/**
+ * @brief Plant model update, run in foreground context every period.
+ *
+ * @param nowNs   Virtual time of this update
+ * @param context Pointer given to SIM_Add_Periodic()
+ */
+typedef void (*SIM_PERIODIC_t)(uint64_t nowNs, void *context);
+
+/**
+ * @brief Runs `update` every `period_us` of virtual time (thermal model, ...).
+ *
+ * @return false if all SIM_PERIODIC_COUNT slots are taken
+ */
+bool SIM_Add_Periodic(SIM_PERIODIC_t update, void *context, uint32_t period_us);
+
+// === Interrupt Latency Model ===
+
+/**
+ * @brief Delays some timer interrupts, like WiFi/flash activity on the chip.
+ *
+ * The alarm itself stays on time (timers auto-reload in hardware); only
+ * the ISR runs late. Pseudo-random but repeatable.
+ *
+ * @param max_ns  Longest added latency, 0 = interrupts are exact
+ * @param percent Share of interrupts that are delayed (0-100)
+ */
+void SIM_Set_ISR_Latency(uint32_t max_ns, uint8_t percent);
+
+// === FreeRTOS Tasks (SIM_RTOS.cpp) ===
+
+/**
+ * @brief True while a FreeRTOS task (not the Arduino loop) holds the CPU.
+ */
+bool SIM_Task_Running(void);
+
+/**
+ * @brief Earliest time a task becomes ready; the clock uses this to
+ *        schedule tasks between alarms.
+ *
+ * @return false inside a task (tasks do not preempt each other) or if no
+ *         task is waiting on a time
+ */
+bool SIM_Task_Next_Wake(uint64_t *when);
+
+/**
+ * @brief Runs the task SIM_Task_Next_Wake() found until it blocks.
+ */
+void SIM_Task_Run_Next(void);
+
+/**
+ * @brief Handles the next alarm, model update or task wake due by `target`.
+ *
+ * The loop waits on FreeRTOS objects in these steps, so it sees a change
+ * at the moment it happens without polling the clock.
+ *
+ * @return false if nothing was due; the clock is then at `target`
+ */
+bool SIM_Advance_Step(uint64_t target);
+
+// === GPIO ===
+
+/**
+ * @brief Drives a pin from the outside (switch, driver FAULT line, ...).
+ *
+ * Runs any interrupt attached to the pin whose edge matches.
+ *
+ * @param pin   GPIO number
+ * @param level HIGH or LOW
+ */
+void SIM_Set_Pin(int pin, int level);
+
+/**
+ * @brief Reads the current level of a pin.
+ */
+int SIM_Get_Pin(int pin);
+
+/**
+ * @brief Average drive of a pin, 0.0-1.0.
+ *
+ * LEDC duty for a pin attached to a PWM channel (its edges are not
+ * simulated), otherwise the current level. Plant models use this for
+ * anything driven by power (heater, ...).
+ */
+float SIM_Get_Pin_Duty(int pin);
+
+/**
+ * @brief Observer of firmware pin writes (digitalWrite() and FAST_GPIO).
+ *
+ * Called for every level change of an OUTPUT pin, in the context of the
+ * code that wrote it (possibly an ISR).
+ */
+typedef void (*SIM_PIN_HOOK_t)(int pin, int level, void *context);
+
+/**
+ * @brief Adds a pin write observer.
+ *
+ * @return false if all SIM_PIN_HOOK_COUNT slots are taken
+ */
+bool SIM_Add_Pin_Hook(SIM_PIN_HOOK_t hook, void *context);
+
+/**
+ * @brief Firmware-side pin write; used by the Arduino API and FAST_GPIO.
+ */
+void SIM_Write_Pin(int pin, int level);
+
+// === ADC ===
+
+/**
+ * @brief Sets the voltage analogReadMilliVolts() returns for a pin.
+ */
+void SIM_Set_Analog_MV(int pin, int millivolts);
+
+/**
+ * @brief Returns the voltage last set for a pin.
+ */
+int SIM_Get_Analog_MV(int pin);
+
+// === WebSocket ===
+
+/**
+ * @brief Observer of text frames the firmware sends to the server.
+ */
+typedef void (*SIM_WS_HOOK_t)(const char *text, size_t length, void *context);
+
+/**
+ * @brief Captures outgoing WebSocket frames, NULL to drop them.
+ */
+void SIM_Set_WebSocket_Hook(SIM_WS_HOOK_t hook, void *context);
+
+/**
+ * @brief Queues a text frame from the server. Like the real client, it
+ *        reaches the firmware's handler on its next webSocket.loop().
+ */
+void SIM_WebSocket_Receive(const char *text);
+
+/**
+ * @brief Firmware-side delivery of queued frames; used by WebSocketsClient::loop().
+ */
+void SIM_WebSocket_Poll(void);
+
+/**
+ * @brief Firmware-side send; used by the WebSocketsClient stand-in.
+ */
+void SIM_WebSocket_Send(const char *text, size_t length);
+
+/**
+ * @brief Firmware-side registration of the receiver for SIM_WebSocket_Receive().
+ */
+void SIM_WebSocket_Set_Receiver(SIM_WS_HOOK_t receiver, void *context);
+
+// === Serial ===
+
+/**
+ * @brief Turns echoing of the firmware's Serial output to stdout on or off.
+ */
+void SIM_Set_Serial_Echo(bool echo);
+
+/**
+ * @brief Queues characters for Serial.read().
+ */
+void SIM_Serial_Input(const char *text);
+
+// === Run Control ===
+
+/**
+ * @brief Ends the run once the current setup()/loop() call returns.
+ *
+ * @param code Process exit code
+ */
+void SIM_Finish(int code);
+
+/**
+ * @brief Returns true once SIM_Finish() has been called.
+ */
+bool SIM_Is_Finished(void);
+
+/**
+ * @brief Exit code given to SIM_Finish().
+ */
+int SIM_Exit_Code(void);
+
+/**
+ * @brief Ends the run with code 0 once virtual time reaches `seconds`.
+ *
+ * @param seconds Virtual run length, 0 = no limit
+ */
+void SIM_Set_Time_Limit(uint32_t seconds);
+
+/**
+ * @brief Wires up the simulated board (axes, switches, heater) before setup().
+ *
+ * Defined in SIM_BOARD.cpp.
+ */
+void SIM_Board_Init(void);
+
+/**
+ * @brief Optional harness entry point, called after SIM_Board_Init() and
+ *        before setup() with the program arguments.
+ *
+ * Weak: builds without a harness just run the sketch.
+ */
+void SIM_Harness_Init(int argc, char **argv) __attribute__((weak));
+
+#endif // SIM_HAL_H
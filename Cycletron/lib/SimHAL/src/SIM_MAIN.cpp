@@ -0,0 +1,39 @@
+/**
+ * @file    SIM_MAIN.cpp
+ * @brief   Host entry point: runs the sketch's setup()/loop() on virtual time
+ *
+ * The loop ends when the sketch (or a harness linked with it) calls
+ * SIM_Finish(); its code becomes the process exit code.
+ *
+ * Options (a harness may take more, see SIM_Harness_Init()):
+ *   --seconds=N  stop after N seconds of virtual time (exit code 0)
+ *   --quiet      do not echo the firmware's Serial output
+ *
+ * Date:   Oct 2026
+ */
+
+#include <Arduino.h>
+#include "SIM_HAL.h"
+
+int main(int argc, char **argv)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seconds=", 10) == 0)
+            SIM_Set_Time_Limit((uint32_t)strtoul(argv[i] + 10, NULL, 10));
+        else if (strcmp(argv[i], "--quiet") == 0)
+            SIM_Set_Serial_Echo(false);
+    }
+
+    SIM_Board_Init();
+    if (SIM_Harness_Init)
+        SIM_Harness_Init(argc, argv);
+    setup();
+    while (!SIM_Is_Finished())
+        loop();
+
+    fflush(stdout);
+    return SIM_Exit_Code();
+}
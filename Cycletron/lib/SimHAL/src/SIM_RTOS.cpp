@@ -0,0 +1,401 @@
+/**
+ * @file    SIM_RTOS.cpp
+ * @brief   FreeRTOS tasks, queues and semaphores on the virtual clock
+ *
+ * Every task gets a host thread so it can block anywhere in its own call
+ * stack, but a baton makes sure only one thread runs at a time: the
+ * Arduino loop (which owns the clock's event loop) or one task. A task
+ * waiting on time registers its wake time; SIM_Advance_To() hands it the
+ * baton when the clock gets there, in order with timer alarms, and takes
+ * it back when the task blocks again. Runs stay repeatable because the
+ * host scheduler never decides anything.
+ *
+ * Date:   Oct 2026
+ */
+
+#include <Arduino.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SIM_HAL.h"
+
+// === Timing ===
+#define SIM_TICK_NS (1000000000ULL / configTICK_RATE_HZ)
+#define SIM_TASK_YIELD_NS 1000ULL  // vTaskDelay(0): let others run for 1 us
+#define SIM_NEVER UINT64_MAX       // Wake time of a task blocked without timeout
+
+#define SIM_LOOP_CORE 1            // Arduino loopTask
+
+struct tskTaskControlBlock
+{
+    TaskFunction_t code;
+    void *parameter;
+    const char *name;
+    UBaseType_t priority;
+    BaseType_t core;
+    uint64_t wakeNs;               // Ready at this time, SIM_NEVER = waiting for a signal
+    const void *waitingOn;         // Queue whose changes wake it early, or NULL
+    bool running;                  // Holds the baton
+    bool deleted;
+    std::condition_variable baton;
+};
+
+struct QueueDefinition
+{
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t length;
+    UBaseType_t itemSize;          // 0 for semaphores
+};
+
+// Never destroyed: blocked task threads are still waiting on them at exit
+static std::mutex *simLock = new std::mutex;
+static std::condition_variable *loopBaton = new std::condition_variable;
+static std::vector<tskTaskControlBlock *> *simTasks = new std::vector<tskTaskControlBlock *>;
+static tskTaskControlBlock *current = NULL; // Task holding the baton, NULL = the loop
+
+// ---------------------------------------------------------------------------
+// Scheduler
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Ready task with the earliest wake time, highest priority first on ties.
+ */
+static tskTaskControlBlock *SIM_Task_Next(void)
+{
+    tskTaskControlBlock *next = NULL;
+    for (tskTaskControlBlock *task : *simTasks)
+    {
+        if (task->deleted || task->wakeNs == SIM_NEVER)
+            continue;
+        if (next == NULL || task->wakeNs < next->wakeNs ||
+            (task->wakeNs == next->wakeNs && task->priority > next->priority))
+            next = task;
+    }
+    return next;
+}
+
+bool SIM_Task_Running(void)
+{
+    return current != NULL;
+}
+
+bool SIM_Task_Next_Wake(uint64_t *when)
+{
+    if (current != NULL)
+        return false;
+    tskTaskControlBlock *next = SIM_Task_Next();
+    if (next == NULL)
+        return false;
+    *when = next->wakeNs;
+    return true;
+}
+
+void SIM_Task_Run_Next(void)
+{
+    tskTaskControlBlock *task = SIM_Task_Next();
+    if (task == NULL || current != NULL)
+        return;
+
+    std::unique_lock<std::mutex> lock(*simLock);
+    task->waitingOn = NULL;
+    task->running = true;
+    current = task;
+    task->baton.notify_one();
+    loopBaton->wait(lock, [] { return current == NULL; });
+}
+
+/**
+ * @brief Gives the baton back to the loop until `wakeNs` or a change of `object`.
+ */
+static void SIM_Task_Block(uint64_t wakeNs, const void *object)
+{
+    tskTaskControlBlock *self = current;
+    std::unique_lock<std::mutex> lock(*simLock);
+    self->wakeNs = wakeNs;
+    self->waitingOn = object;
+    self->running = false;
+    current = NULL;
+    loopBaton->notify_one();
+    self->baton.wait(lock, [self] { return self->running; });
+}
+
+/**
+ * @brief Makes every task waiting on `object` ready now.
+ */
+static void SIM_Task_Signal(const void *object)
+{
+    uint64_t now = SIM_Now_Ns();
+    for (tskTaskControlBlock *task : *simTasks)
+    {
+        if (!task->deleted && task->waitingOn == object && task->wakeNs > now)
+            task->wakeNs = now;
+    }
+}
+
+/**
+ * @brief Waits up to `ticks` for `ready()`: a task blocks on `object`, the
+ *        loop steps the clock from one event to the next (or in yield()
+ *        steps when it waits forever).
+ */
+template <typename READY>
+static bool SIM_Task_Wait_For(const void *object, TickType_t ticks, READY ready)
+{
+    uint64_t deadline = (ticks == portMAX_DELAY) ? SIM_NEVER : SIM_Now_Ns() + ticks * SIM_TICK_NS;
+    while (!ready())
+    {
+        if (SIM_Now_Ns() >= deadline)
+            return false;
+        if (current != NULL)
+            SIM_Task_Block(deadline, object);
+        else if (deadline == SIM_NEVER)
+            yield();
+        else
+            SIM_Advance_Step(deadline);
+    }
+    return true;
+}
+
+static void SIM_Task_Entry(tskTaskControlBlock *self)
+{
+    {
+        std::unique_lock<std::mutex> lock(*simLock);
+        self->baton.wait(lock, [self] { return self->running; });
+    }
+    self->code(self->parameter);
+    vTaskDelete(NULL); // Returning from a task function is not allowed in FreeRTOS either
+}
+
+// ---------------------------------------------------------------------------
+// Tasks
+// ---------------------------------------------------------------------------
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, uint32_t stackDepth,
+                                   void *parameter, UBaseType_t priority, TaskHandle_t *created,
+                                   BaseType_t core)
+{
+    (void)stackDepth;
+    tskTaskControlBlock *task = new tskTaskControlBlock();
+    task->code = code;
+    task->parameter = parameter;
+    task->name = name;
+    task->priority = priority < configMAX_PRIORITIES ? priority : configMAX_PRIORITIES - 1;
+    task->core = core;
+    task->wakeNs = SIM_Now_Ns();
+    task->waitingOn = NULL;
+    task->running = false;
+    task->deleted = false;
+    simTasks->push_back(task);
+    std::thread(SIM_Task_Entry, task).detach();
+
+    if (created)
+        *created = task;
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name, uint32_t stackDepth, void *parameter,
+                       UBaseType_t priority, TaskHandle_t *created)
+{
+    return xTaskCreatePinnedToCore(code, name, stackDepth, parameter, priority, created, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL)
+        task = current;
+    if (task == NULL)
+        return; // The loop cannot delete itself
+    task->deleted = true;
+
+    // Deleting itself: park the thread for good (it is detached)
+    if (task == current)
+    {
+        SIM_Task_Block(SIM_NEVER, NULL);
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (current == NULL)
+    {
+        SIM_Advance_Ns(ticks * SIM_TICK_NS);
+        return;
+    }
+    SIM_Task_Block(SIM_Now_Ns() + (ticks ? ticks * SIM_TICK_NS : SIM_TASK_YIELD_NS), NULL);
+}
+
+BaseType_t xTaskDelayUntil(TickType_t *previousWake, TickType_t increment)
+{
+    TickType_t wake = *previousWake + increment;
+    *previousWake = wake;
+
+    TickType_t now = xTaskGetTickCount();
+    int32_t ahead = (int32_t)(wake - now);
+    if (ahead <= 0)
+        return pdFALSE;
+
+    uint64_t wakeNs = (SIM_Now_Ns() / SIM_TICK_NS + (uint64_t)ahead) * SIM_TICK_NS; // On the tick
+    if (current == NULL)
+        SIM_Advance_Ns(wakeNs - SIM_Now_Ns());
+    else
+        SIM_Task_Block(wakeNs, NULL);
+    return pdTRUE;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(SIM_Now_Ns() / SIM_TICK_NS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return current;
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    if (current == NULL)
+        return SIM_LOOP_CORE;
+    return current->core == tskNO_AFFINITY ? 0 : current->core;
+}
+
+// ---------------------------------------------------------------------------
+// Queues and semaphores
+// ---------------------------------------------------------------------------
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+    if (length == 0)
+        return NULL;
+    QueueDefinition *queue = new QueueDefinition();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount)
+{
+    QueueHandle_t semaphore = xQueueCreate(maxCount, 0);
+    if (semaphore == NULL)
+        return NULL;
+    for (UBaseType_t i = 0; i < initialCount && i < maxCount; i++)
+        semaphore->items.emplace_back();
+    return semaphore;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+/**
+ * @brief Copies an item in; the caller has checked for space.
+ */
+static void SIM_Queue_Put(QueueHandle_t queue, const void *item, bool front)
+{
+    const uint8_t *bytes = (const uint8_t *)item;
+    std::vector<uint8_t> copy;
+    if (queue->itemSize && bytes)
+        copy.assign(bytes, bytes + queue->itemSize);
+    if (front)
+        queue->items.push_front(copy);
+    else
+        queue->items.push_back(copy);
+    SIM_Task_Signal(queue);
+}
+
+/**
+ * @brief Copies the front item out (and removes it unless peeking).
+ */
+static void SIM_Queue_Get(QueueHandle_t queue, void *buffer, bool peek)
+{
+    if (queue->itemSize && buffer)
+        memcpy(buffer, queue->items.front().data(), queue->itemSize);
+    if (!peek)
+    {
+        queue->items.pop_front();
+        SIM_Task_Signal(queue);
+    }
+}
+
+static BaseType_t SIM_Queue_Send(QueueHandle_t queue, const void *item, TickType_t ticks, bool front)
+{
+    if (!SIM_Task_Wait_For(queue, ticks, [queue] { return queue->items.size() < queue->length; }))
+        return errQUEUE_FULL;
+    SIM_Queue_Put(queue, item, front);
+    return pdTRUE;
+}
+
+static BaseType_t SIM_Queue_Receive(QueueHandle_t queue, void *buffer, TickType_t ticks, bool peek)
+{
+    if (!SIM_Task_Wait_For(queue, ticks, [queue] { return !queue->items.empty(); }))
+        return errQUEUE_EMPTY;
+    SIM_Queue_Get(queue, buffer, peek);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    return SIM_Queue_Send(queue, item, ticks, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    return SIM_Queue_Send(queue, item, ticks, true);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item)
+{
+    queue->items.clear();
+    SIM_Queue_Put(queue, item, false);
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t ticks)
+{
+    return SIM_Queue_Receive(queue, buffer, ticks, false);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *buffer, TickType_t ticks)
+{
+    return SIM_Queue_Receive(queue, buffer, ticks, true);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    return (UBaseType_t)queue->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue)
+{
+    return queue->length - (UBaseType_t)queue->items.size();
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    queue->items.clear();
+    SIM_Task_Signal(queue);
+    return pdPASS;
+}
+
+BaseType_t xQueueSendToBackFromISR(QueueHandle_t queue, const void *item, BaseType_t *woken)
+{
+    if (woken)
+        *woken = pdFALSE;
+    return SIM_Queue_Send(queue, item, 0, false);
+}
+
+BaseType_t xQueueOverwriteFromISR(QueueHandle_t queue, const void *item, BaseType_t *woken)
+{
+    if (woken)
+        *woken = pdFALSE;
+    return xQueueOverwrite(queue, item);
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void *buffer, BaseType_t *woken)
+{
+    if (woken)
+        *woken = pdFALSE;
+    return SIM_Queue_Receive(queue, buffer, 0, false);
+}
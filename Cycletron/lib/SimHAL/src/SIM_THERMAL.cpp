@@ -0,0 +1,73 @@
+/**
+ * @file    SIM_THERMAL.cpp
+ * @brief   Heater pad and thermistor model
+ *
+ * Date:   Oct 2026
+ */
+
+#include <Arduino.h>
+#include "SIM_THERMAL.h"
+#include "SIM_HAL.h"
+
+// === Thermistor Divider (matches HEATING.cpp) ===
+#define SIM_THERMAL_VREF 3.28
+#define SIM_THERMAL_R0 100000.0
+#define SIM_THERMAL_R1 4630.0
+#define SIM_THERMAL_BETA 3850.0
+#define SIM_THERMAL_T0 298.15
+#define SIM_THERMAL_ADC_OFFSET_MV 18 // HEATING.cpp adds this back
+
+static SIM_THERMAL_CONFIG_t thermal;
+static float padC = 0;
+static float sensorC = 0;
+static uint32_t noiseSeed = 0x9E3779B9;
+
+/**
+ * @brief Divider output for a thermistor temperature, as the ADC reports it.
+ */
+static int SIM_THERMAL_Divider_MV(float tempC)
+{
+    double r = SIM_THERMAL_R0 * exp(SIM_THERMAL_BETA * (1.0 / (tempC + 273.15) - 1.0 / SIM_THERMAL_T0));
+    double volts = SIM_THERMAL_VREF * SIM_THERMAL_R1 / (r + SIM_THERMAL_R1);
+    return (int)lround(volts * 1000.0) - SIM_THERMAL_ADC_OFFSET_MV;
+}
+
+/**
+ * @brief One model step: pad and sensor lags, then the ADC input.
+ */
+static void SIM_THERMAL_Update(uint64_t nowNs, void *context)
+{
+    (void)nowNs;
+    (void)context;
+    const float dt = SIM_THERMAL_PERIOD_US / 1e6f;
+
+    float target = thermal.ambient_c + SIM_Get_Pin_Duty(thermal.heater_pin) * thermal.full_power_rise;
+    padC += (target - padC) * dt / thermal.tau_s;
+    sensorC += (padC - sensorC) * dt / thermal.sensor_tau_s;
+
+    int noise = 0;
+    if (thermal.noise_mv > 0)
+    {
+        noiseSeed = noiseSeed * 1664525u + 1013904223u;
+        noise = (int)((noiseSeed >> 16) % (uint32_t)(2 * thermal.noise_mv + 1)) - thermal.noise_mv;
+    }
+    SIM_Set_Analog_MV(thermal.thermistor_pin, SIM_THERMAL_Divider_MV(sensorC) + noise);
+}
+
+void SIM_THERMAL_Init(const SIM_THERMAL_CONFIG_t *config)
+{
+    thermal = *config;
+    padC = sensorC = thermal.ambient_c;
+    SIM_Set_Analog_MV(thermal.thermistor_pin, SIM_THERMAL_Divider_MV(sensorC));
+    SIM_Add_Periodic(SIM_THERMAL_Update, NULL, SIM_THERMAL_PERIOD_US);
+}
+
+float SIM_THERMAL_Pad_C(void)
+{
+    return padC;
+}
+
+float SIM_THERMAL_Sensor_C(void)
+{
+    return sensorC;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file    SIM_THERMAL.h
+ * @brief   Heater pad and thermistor model (native builds only)
+ *
+ * First-order thermal plant: the pad heads for ambient + duty *
+ * full_power_rise with time constant tau, where duty is the heater pin's
+ * average drive (LEDC duty or plain level, see SIM_Get_Pin_Duty()). The
+ * thermistor follows the pad with its own (shorter) lag and is presented
+ * to the ADC through the same divider as the board (100k NTC, BETA 3850,
+ * 4.63k to ground, 3.28 V), so HEATING.cpp's conversion reads back the
+ * modelled sensor temperature.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_THERMAL_H
+#define SIM_THERMAL_H
+
+#include <stdint.h>
+
+#define SIM_THERMAL_PERIOD_US 10000 // Model step (10 ms)
+
+/**
+ * @struct SIM_THERMAL_CONFIG_t
+ * @brief  Plant parameters.
+ */
+typedef struct
+{
+    int heater_pin;         ///< Output driving the heater switch (HIGH = on)
+    int thermistor_pin;     ///< ADC input of the divider
+    float ambient_c;        ///< Room temperature
+    float full_power_rise;  ///< Steady-state rise above ambient at 100% duty (C)
+    float tau_s;            ///< Pad time constant (s)
+    float sensor_tau_s;     ///< Thermistor lag behind the pad (s)
+    int noise_mv;           ///< Peak ADC noise (mV), repeatable
+} SIM_THERMAL_CONFIG_t;
+
+/**
+ * @brief Starts the model; the pad begins at ambient.
+ */
+void SIM_THERMAL_Init(const SIM_THERMAL_CONFIG_t *config);
+
+/**
+ * @brief Modelled pad temperature (C).
+ */
+float SIM_THERMAL_Pad_C(void);
+
+/**
+ * @brief Modelled thermistor temperature (C).
+ */
+float SIM_THERMAL_Sensor_C(void);
+
+#endif // SIM_THERMAL_H
@@ -0,0 +1,175 @@
+/**
+ * @file    WString.h
+ * @brief   Arduino String for the simulated hardware layer
+ *
+ * Covers the part of the Arduino String API the firmware and ArduinoJson
+ * use, on top of std::string.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_WSTRING_H
+#define SIM_WSTRING_H
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+class String
+{
+public:
+    String() {}
+    String(const char *cstr) : str(cstr ? cstr : "") {}
+    String(const char *cstr, size_t length) : str(cstr ? std::string(cstr, length) : std::string()) {}
+    String(const std::string &s) : str(s) {}
+    explicit String(char c) : str(1, c) {}
+    explicit String(int value, unsigned char base = 10) : str(format(value, base)) {}
+    explicit String(unsigned int value, unsigned char base = 10) : str(format(value, base)) {}
+    explicit String(long value, unsigned char base = 10) : str(format(value, base)) {}
+    explicit String(unsigned long value, unsigned char base = 10) : str(format(value, base)) {}
+    explicit String(float value, unsigned int decimals = 2) : str(format((double)value, decimals)) {}
+    explicit String(double value, unsigned int decimals = 2) : str(format(value, decimals)) {}
+
+    String &operator=(const char *cstr)
+    {
+        str = cstr ? cstr : "";
+        return *this;
+    }
+
+    const char *c_str() const { return str.c_str(); }
+    unsigned int length() const { return (unsigned int)str.length(); }
+    bool isEmpty() const { return str.empty(); }
+    void reserve(unsigned int size) { str.reserve(size); }
+    char charAt(unsigned int index) const { return index < str.length() ? str[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+
+    bool concat(const String &s) { str += s.str; return true; }
+    bool concat(const char *cstr) { if (cstr) str += cstr; return cstr != NULL; }
+    bool concat(const char *cstr, unsigned int length) { if (cstr) str.append(cstr, length); return cstr != NULL; }
+    bool concat(char c) { str += c; return true; }
+    bool concat(int value) { return concat(String(value)); }
+    bool concat(unsigned long value) { return concat(String(value)); }
+    bool concat(double value) { return concat(String(value)); }
+
+    template <typename T>
+    String &operator+=(const T &value)
+    {
+        concat(value);
+        return *this;
+    }
+
+    bool equals(const String &s) const { return str == s.str; }
+    bool equals(const char *cstr) const { return str == (cstr ? cstr : ""); }
+    bool operator==(const String &s) const { return equals(s); }
+    bool operator==(const char *cstr) const { return equals(cstr); }
+    bool operator!=(const String &s) const { return !equals(s); }
+    bool operator!=(const char *cstr) const { return !equals(cstr); }
+    bool operator<(const String &s) const { return str < s.str; }
+    bool startsWith(const String &prefix) const { return str.compare(0, prefix.str.length(), prefix.str) == 0; }
+    bool endsWith(const String &suffix) const
+    {
+        return str.length() >= suffix.str.length() &&
+               str.compare(str.length() - suffix.str.length(), suffix.str.length(), suffix.str) == 0;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const { return position(str.find(c, from)); }
+    int indexOf(const String &s, unsigned int from = 0) const { return position(str.find(s.str, from)); }
+    String substring(unsigned int from) const { return from < str.length() ? String(str.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        if (from > to) { unsigned int t = from; from = to; to = t; }
+        return from < str.length() ? String(str.substr(from, to - from)) : String();
+    }
+
+    long toInt() const { return atol(str.c_str()); }
+    float toFloat() const { return (float)atof(str.c_str()); }
+    double toDouble() const { return atof(str.c_str()); }
+    void toLowerCase() { for (size_t i = 0; i < str.length(); i++) str[i] = (char)tolower((unsigned char)str[i]); }
+    void toUpperCase() { for (size_t i = 0; i < str.length(); i++) str[i] = (char)toupper((unsigned char)str[i]); }
+    void trim()
+    {
+        size_t begin = str.find_first_not_of(" \t\r\n");
+        size_t end = str.find_last_not_of(" \t\r\n");
+        str = (begin == std::string::npos) ? std::string() : str.substr(begin, end - begin + 1);
+    }
+
+private:
+    std::string str;
+
+    static int position(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+
+    static std::string format(long value, unsigned char base)
+    {
+        if (base == 10)
+            return std::to_string(value);
+        return format((unsigned long)value, base);
+    }
+
+    static std::string format(unsigned long value, unsigned char base)
+    {
+        if (base < 2 || base > 36)
+            base = 10;
+        char buffer[8 * sizeof(long) + 1];
+        char *p = &buffer[sizeof(buffer) - 1];
+        *p = '\0';
+        do
+        {
+            unsigned digit = value % base;
+            *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+            value /= base;
+        } while (value);
+        return p;
+    }
+
+    static std::string format(int value, unsigned char base) { return format((long)value, base); }
+    static std::string format(unsigned int value, unsigned char base) { return format((unsigned long)value, base); }
+
+    static std::string format(double value, unsigned int decimals)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+        return buffer;
+    }
+};
+
+/**
+ * @brief Result type of String concatenation, as in the Arduino core.
+ */
+class StringSumHelper : public String
+{
+public:
+    StringSumHelper(const String &s) : String(s) {}
+    StringSumHelper(const char *cstr) : String(cstr) {}
+};
+
+inline StringSumHelper operator+(const String &lhs, const String &rhs)
+{
+    StringSumHelper sum(lhs);
+    sum.concat(rhs);
+    return sum;
+}
+
+inline StringSumHelper operator+(const String &lhs, const char *rhs)
+{
+    StringSumHelper sum(lhs);
+    sum.concat(rhs);
+    return sum;
+}
+
+inline StringSumHelper operator+(const char *lhs, const String &rhs)
+{
+    StringSumHelper sum(lhs);
+    sum.concat(rhs);
+    return sum;
+}
+
+inline StringSumHelper operator+(const String &lhs, char rhs)
+{
+    StringSumHelper sum(lhs);
+    sum.concat(rhs);
+    return sum;
+}
+
+#endif // SIM_WSTRING_H
@@ -0,0 +1,71 @@
+/**
+ * @file    WebSocketsClient.h
+ * @brief   WebSocket client stand-in for the simulated hardware layer
+ *
+ * Frames the firmware sends go to the hook set with
+ * SIM_Set_WebSocket_Hook(); frames queued with SIM_WebSocket_Receive() reach
+ * the handler registered with onEvent() from loop(), as with the real client.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_WEBSOCKETSCLIENT_H
+#define SIM_WEBSOCKETSCLIENT_H
+
+#include <Arduino.h>
+
+typedef enum
+{
+    WStype_ERROR,
+    WStype_DISCONNECTED,
+    WStype_CONNECTED,
+    WStype_TEXT,
+    WStype_BIN,
+    WStype_PING,
+    WStype_PONG
+} WStype_t;
+
+/**
+ * @brief Client that is always connected to the simulated server.
+ */
+class WebSocketsClient
+{
+public:
+    typedef void (*WebSocketClientEvent)(WStype_t type, uint8_t *payload, size_t length);
+
+    void begin(const char *host, uint16_t port, const char *url = "/", const char *protocol = "arduino")
+    {
+        (void)host;
+        (void)port;
+        (void)url;
+        (void)protocol;
+    }
+    void onEvent(WebSocketClientEvent handler)
+    {
+        eventHandler = handler;
+        SIM_WebSocket_Set_Receiver(Deliver, this);
+    }
+    void loop() { SIM_WebSocket_Poll(); }
+    bool isConnected() { return true; }
+    void setReconnectInterval(unsigned long ms) { (void)ms; }
+
+    bool sendTXT(const char *payload, size_t length = 0)
+    {
+        SIM_WebSocket_Send(payload, length ? length : strlen(payload));
+        return true;
+    }
+    bool sendTXT(const uint8_t *payload, size_t length = 0) { return sendTXT((const char *)payload, length); }
+    bool sendTXT(const String &payload) { return sendTXT(payload.c_str(), payload.length()); }
+
+private:
+    WebSocketClientEvent eventHandler = NULL;
+
+    static void Deliver(const char *text, size_t length, void *context)
+    {
+        WebSocketsClient *client = (WebSocketsClient *)context;
+        if (client->eventHandler)
+            client->eventHandler(WStype_TEXT, (uint8_t *)text, length);
+    }
+};
+
+#endif // SIM_WEBSOCKETSCLIENT_H
@@ -0,0 +1,79 @@
+/**
+ * @file    WiFi.h
+ * @brief   WiFi stand-in for the simulated hardware layer
+ *
+ * Always connected; scans finish immediately with no networks.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum
+{
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum
+{
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+/**
+ * @brief IPv4 address (loopback in the simulator).
+ */
+class IPAddress
+{
+public:
+    String toString() const { return String("127.0.0.1"); }
+};
+
+/**
+ * @brief WiFi station that is connected as soon as it is started.
+ */
+class WiFiClass
+{
+public:
+    wl_status_t begin(const char *ssid, const char *password = NULL)
+    {
+        (void)ssid;
+        (void)password;
+        return WL_CONNECTED;
+    }
+    bool mode(wifi_mode_t mode)
+    {
+        (void)mode;
+        return true;
+    }
+    bool disconnect(bool wifiOff = false)
+    {
+        (void)wifiOff;
+        return true;
+    }
+    wl_status_t status() { return WL_CONNECTED; }
+    IPAddress localIP() { return IPAddress(); }
+    String macAddress() { return String("02:00:00:00:00:01"); }
+    int16_t scanNetworks(bool async = false)
+    {
+        (void)async;
+        return 0;
+    }
+    int16_t scanComplete() { return 0; }
+    void scanDelete() {}
+};
+
+extern WiFiClass WiFi;
+
+#endif // SIM_WIFI_H
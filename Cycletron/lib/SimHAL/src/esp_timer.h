@@ -0,0 +1,18 @@
+/**
+ * @file    esp_timer.h
+ * @brief   esp_timer_get_time() for the simulated hardware layer
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_ESP_TIMER_H
+#define SIM_ESP_TIMER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Virtual microseconds since start.
+ */
+int64_t esp_timer_get_time(void);
+
+#endif // SIM_ESP_TIMER_H
@@ -0,0 +1,64 @@
+/**
+ * @file    FreeRTOS.h
+ * @brief   FreeRTOS types and configuration for the simulated hardware layer
+ *
+ * The subset of the ESP-IDF FreeRTOS API the firmware uses, with the same
+ * names, so task code builds unchanged for the host. Tasks run one at a
+ * time on the virtual clock (see SIM_RTOS.cpp); the tick is 1 ms as in
+ * the Arduino-ESP32 core.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// === Configuration ===
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define configMINIMAL_STACK_SIZE 768
+
+// === Types ===
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+// === Constants ===
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define errQUEUE_EMPTY ((BaseType_t)0)
+#define errQUEUE_FULL ((BaseType_t)0)
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((TickType_t)(ms) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+#define pdTICKS_TO_MS(ticks) ((TickType_t)(((TickType_t)(ticks) * (TickType_t)1000U) / (TickType_t)configTICK_RATE_HZ))
+
+// === Critical Sections ===
+// Only one task or ISR runs at a time here, so these only need to compile.
+typedef struct
+{
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+#define portYIELD_FROM_ISR(...) ((void)0)
+
+/**
+ * @brief Core the caller runs on: a task's pinned core, 1 for the Arduino
+ *        loop (as on the chip).
+ */
+BaseType_t xPortGetCoreID(void);
+
+#endif // SIM_FREERTOS_H
@@ -0,0 +1,68 @@
+/**
+ * @file    queue.h
+ * @brief   FreeRTOS queues for the simulated hardware layer
+ *
+ * Items are copied in and out as on the chip. A task that blocks on a
+ * queue wakes when another task, the loop or an ISR changes it, or when
+ * its timeout passes; the loop polls, letting time pass in yield() steps.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_FREERTOS_QUEUE_H
+#define SIM_FREERTOS_QUEUE_H
+
+#include "FreeRTOS.h"
+
+typedef struct QueueDefinition *QueueHandle_t;
+
+/**
+ * @brief Creates a queue of `length` items of `itemSize` bytes.
+ */
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+
+void vQueueDelete(QueueHandle_t queue);
+
+/**
+ * @brief Copies an item to the back, waiting up to `ticks` for space.
+ *
+ * @return pdTRUE, or errQUEUE_FULL on timeout
+ */
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item, TickType_t ticks);
+
+/**
+ * @brief Copies an item to the front, waiting up to `ticks` for space.
+ */
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t ticks);
+
+#define xQueueSend(queue, item, ticks) xQueueSendToBack((queue), (item), (ticks))
+
+/**
+ * @brief Replaces the item of a length-1 queue (a mailbox); never waits.
+ */
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item);
+
+/**
+ * @brief Moves the front item to `buffer`, waiting up to `ticks` for one.
+ *
+ * @return pdTRUE, or errQUEUE_EMPTY on timeout
+ */
+BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t ticks);
+
+/**
+ * @brief xQueueReceive() that leaves the item in the queue.
+ */
+BaseType_t xQueuePeek(QueueHandle_t queue, void *buffer, TickType_t ticks);
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+BaseType_t xQueueReset(QueueHandle_t queue);
+
+// === From ISRs (never wait; `woken` is always set to pdFALSE here) ===
+BaseType_t xQueueSendToBackFromISR(QueueHandle_t queue, const void *item, BaseType_t *woken);
+BaseType_t xQueueOverwriteFromISR(QueueHandle_t queue, const void *item, BaseType_t *woken);
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void *buffer, BaseType_t *woken);
+
+#define xQueueSendFromISR(queue, item, woken) xQueueSendToBackFromISR((queue), (item), (woken))
+
+#endif // SIM_FREERTOS_QUEUE_H
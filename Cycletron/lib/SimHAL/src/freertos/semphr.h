@@ -0,0 +1,34 @@
+/**
+ * @file    semphr.h
+ * @brief   FreeRTOS semaphores and mutexes for the simulated hardware layer
+ *
+ * As in FreeRTOS, a semaphore is a queue of zero-size items: give sends
+ * one, take receives one. Mutexes have no priority inheritance here.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_FREERTOS_SEMPHR_H
+#define SIM_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+#include "queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+/**
+ * @brief Counting semaphore of `maxCount`, starting at `initialCount`.
+ */
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount);
+
+#define xSemaphoreCreateBinary() xSemaphoreCreateCounting(1, 0)
+#define xSemaphoreCreateMutex() xSemaphoreCreateCounting(1, 1)
+#define vSemaphoreDelete(semaphore) vQueueDelete(semaphore)
+
+#define xSemaphoreTake(semaphore, ticks) xQueueReceive((semaphore), NULL, (ticks))
+#define xSemaphoreGive(semaphore) xQueueSendToBack((semaphore), NULL, 0)
+#define xSemaphoreTakeFromISR(semaphore, woken) xQueueReceiveFromISR((semaphore), NULL, (woken))
+#define xSemaphoreGiveFromISR(semaphore, woken) xQueueSendToBackFromISR((semaphore), NULL, (woken))
+#define uxSemaphoreGetCount(semaphore) uxQueueMessagesWaiting(semaphore)
+
+#endif // SIM_FREERTOS_SEMPHR_H
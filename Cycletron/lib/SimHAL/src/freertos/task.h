@@ -0,0 +1,73 @@
+/**
+ * @file    task.h
+ * @brief   FreeRTOS tasks for the simulated hardware layer
+ *
+ * Each task runs on its own host thread, but only one thread (a task or
+ * the Arduino loop) runs at any moment. A task runs from the virtual time
+ * it becomes ready until it blocks; while it runs, timer alarms still fire
+ * on time but no other task or the loop does, as on a core that is busy
+ * with a higher-priority task. Tasks ready at the same time run highest
+ * priority first.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef SIM_FREERTOS_TASK_H
+#define SIM_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+#define tskIDLE_PRIORITY ((UBaseType_t)0)
+#define tskNO_AFFINITY ((BaseType_t)0x7FFFFFFF)
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+/**
+ * @brief Creates a task; it first runs the next time the loop lets time pass.
+ *
+ * The stack depth is ignored (host threads have their own stacks).
+ *
+ * @return pdPASS
+ */
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, uint32_t stackDepth,
+                                   void *parameter, UBaseType_t priority, TaskHandle_t *created,
+                                   BaseType_t core);
+
+/**
+ * @brief xTaskCreatePinnedToCore() with no core affinity.
+ */
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name, uint32_t stackDepth, void *parameter,
+                       UBaseType_t priority, TaskHandle_t *created);
+
+/**
+ * @brief Stops a task, NULL for the caller (does not return then).
+ */
+void vTaskDelete(TaskHandle_t task);
+
+/**
+ * @brief Blocks the calling task for `ticks`; from the loop, same as delay().
+ */
+void vTaskDelay(TickType_t ticks);
+
+/**
+ * @brief Blocks until `*previousWake + increment` and advances `*previousWake`,
+ *        for tasks that must run at a fixed period.
+ *
+ * @return pdFALSE if that time had already passed (no delay)
+ */
+BaseType_t xTaskDelayUntil(TickType_t *previousWake, TickType_t increment);
+
+#define vTaskDelayUntil(previousWake, increment) ((void)xTaskDelayUntil((previousWake), (increment)))
+
+/**
+ * @brief Ticks since start.
+ */
+TickType_t xTaskGetTickCount(void);
+
+/**
+ * @brief Calling task, NULL from the loop.
+ */
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+#endif // SIM_FREERTOS_TASK_H
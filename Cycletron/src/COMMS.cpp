@@ -0,0 +1,144 @@
+/**
+ * @file    COMMS.cpp
+ * @brief   WebSocket link to the server, run by its own task
+ *
+ * The task alternates between webSocket.loop() (receive, keep-alive,
+ * reconnect) and draining the outbox; waiting on the outbox is also its
+ * poll period, so a queued frame goes out at once.
+ *
+ * Date:   Oct 2026
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WebSocketsClient.h>
+#include "COMMS.h"
+#include "globals.h"
+
+static QueueHandle_t outbox = NULL;
+static QueueHandle_t inbox = NULL;
+static volatile uint32_t sendDropped = 0;    // Senders: outbox full or frame too long
+static volatile uint32_t receiveDropped = 0; // Comms task: inbox full or frame too long
+static COMMS_HOOK_t receiveHook = NULL;
+
+/**
+ * @brief Copies a received frame into the inbox (comms task).
+ */
+static void COMMS_Queue_Received(const uint8_t *payload, size_t length)
+{
+    static COMMS_FRAME_t frame; // Only the comms task gets here
+    if (length >= COMMS_FRAME_SIZE)
+    {
+        Serial.printf("[COMMS] Dropped %u byte frame (too long)\n", (unsigned)length);
+        receiveDropped++;
+        return;
+    }
+    frame.length = (uint16_t)length;
+    memcpy(frame.text, payload, length);
+    frame.text[length] = '\0';
+    if (xQueueSend(inbox, &frame, 0) != pdTRUE)
+    {
+        Serial.println("[COMMS] Inbox full, dropped received frame");
+        receiveDropped++;
+        return;
+    }
+    if (receiveHook)
+        receiveHook();
+}
+
+/**
+ * @brief WebSocket events, in the comms task (from webSocket.loop()).
+ */
+static void COMMS_On_Event(WStype_t type, uint8_t *payload, size_t length)
+{
+    switch (type)
+    {
+    case WStype_CONNECTED:
+    {
+        Serial.println("WebSocket connected");
+        ArduinoJson::JsonDocument doc;
+        doc["from"] = "esp32";
+        doc["type"] = "heartbeat";
+        char buffer[64];
+        serializeJson(doc, buffer);
+        webSocket.sendTXT(buffer);
+        Serial.println("Sent heartbeat packet to frontend.");
+        break;
+    }
+
+    case WStype_DISCONNECTED:
+        Serial.println("WebSocket disconnected");
+        break;
+
+    case WStype_TEXT:
+        COMMS_Queue_Received(payload, length);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void COMMS_Task(void *parameter)
+{
+    (void)parameter;
+    static COMMS_FRAME_t frame;
+    for (;;)
+    {
+        webSocket.loop();
+        if (xQueueReceive(outbox, &frame, pdMS_TO_TICKS(COMMS_POLL_MS)) == pdTRUE)
+        {
+            do
+            {
+                webSocket.sendTXT((const char *)frame.text, frame.length);
+            } while (xQueueReceive(outbox, &frame, 0) == pdTRUE);
+        }
+    }
+}
+
+void COMMS_Init(const char *host, uint16_t port, const char *path)
+{
+    outbox = xQueueCreate(COMMS_OUTBOX_SIZE, sizeof(COMMS_FRAME_t));
+    inbox = xQueueCreate(COMMS_INBOX_SIZE, sizeof(COMMS_FRAME_t));
+    webSocket.begin(host, port, path);
+    webSocket.onEvent(COMMS_On_Event);
+    xTaskCreatePinnedToCore(COMMS_Task, "comms", COMMS_TASK_STACK, NULL, COMMS_TASK_PRIORITY, NULL,
+                            COMMS_TASK_CORE);
+}
+
+void COMMS_Set_Receive_Hook(COMMS_HOOK_t hook)
+{
+    receiveHook = hook;
+}
+
+bool COMMS_Send(const char *text)
+{
+    size_t length = strlen(text);
+    if (outbox == NULL || length >= COMMS_FRAME_SIZE)
+    {
+        Serial.printf("[COMMS] Dropped %u byte frame\n", (unsigned)length);
+        sendDropped++;
+        return false;
+    }
+
+    COMMS_FRAME_t frame;
+    frame.length = (uint16_t)length;
+    memcpy(frame.text, text, length + 1);
+    if (xQueueSend(outbox, &frame, 0) != pdTRUE)
+    {
+        Serial.println("[COMMS] Outbox full, dropped frame");
+        sendDropped++;
+        return false;
+    }
+    return true;
+}
+
+bool COMMS_Receive(COMMS_FRAME_t *frame, TickType_t ticks)
+{
+    return inbox != NULL && xQueueReceive(inbox, frame, ticks) == pdTRUE;
+}
+
+uint32_t COMMS_Dropped(void)
+{
+    return sendDropped + receiveDropped;
+}
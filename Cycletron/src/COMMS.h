@@ -0,0 +1,93 @@
+/**
+ * @file    COMMS.h
+ * @brief   WebSocket link to the server, run by its own task
+ *
+ * The comms task owns the WebSocketsClient (`webSocket` in globals.cpp):
+ * it is the only code that calls into it, so reconnects, TLS/TCP stalls and
+ * WiFi bursts stay on the network core and never delay control or motion.
+ * Everything else talks to it through two queues of text frames:
+ *
+ *   outbox  COMMS_Send() copies a serialized frame in; the task sends it
+ *   inbox   frames from the server, taken by COMMS_Receive() in the task
+ *           that runs the state machine; the receive hook wakes it
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef COMMS_H
+#define COMMS_H
+
+#include <Arduino.h>
+
+// === Queues ===
+#define COMMS_FRAME_SIZE 768   // Longest frame in either direction, with its terminator
+#define COMMS_OUTBOX_SIZE 16   // Frames waiting to be sent
+#define COMMS_INBOX_SIZE 8     // Received frames waiting for the state machine
+
+// === Task ===
+#define COMMS_TASK_CORE 0      // With the WiFi stack
+#define COMMS_TASK_PRIORITY 3
+#define COMMS_TASK_STACK 8192
+#define COMMS_POLL_MS 10       // webSocket.loop() period while nothing is sent
+
+/**
+ * @brief Called in the comms task after a frame is put in the inbox.
+ *
+ * Must not block.
+ */
+typedef void (*COMMS_HOOK_t)(void);
+
+/**
+ * @struct COMMS_FRAME_t
+ * @brief  One text frame, NUL-terminated.
+ */
+typedef struct
+{
+    uint16_t length;              ///< Characters in text, without the terminator
+    char text[COMMS_FRAME_SIZE];  ///< Frame payload
+} COMMS_FRAME_t;
+
+/**
+ * @brief Connects the WebSocket client and starts the comms task.
+ *
+ * Call once WiFi is up.
+ *
+ * @param host Server address
+ * @param port Server port
+ * @param path WebSocket path
+ */
+void COMMS_Init(const char *host, uint16_t port, const char *path);
+
+/**
+ * @brief Sets the function called when a frame arrives, NULL for none.
+ *
+ * Set it before COMMS_Init() so no frame goes unnoticed.
+ */
+void COMMS_Set_Receive_Hook(COMMS_HOOK_t hook);
+
+/**
+ * @brief Queues a text frame for the server; never waits.
+ *
+ * Safe from any task. The text is copied.
+ *
+ * @param text NUL-terminated frame
+ * @return false if it is longer than COMMS_FRAME_SIZE - 1 or the outbox is
+ *         full (counted by COMMS_Dropped())
+ */
+bool COMMS_Send(const char *text);
+
+/**
+ * @brief Takes the oldest frame received from the server.
+ *
+ * @param frame Filled with the frame
+ * @param ticks How long to wait for one, 0 = do not wait
+ * @return true if a frame was returned
+ */
+bool COMMS_Receive(COMMS_FRAME_t *frame, TickType_t ticks);
+
+/**
+ * @brief Frames dropped because a queue was full or they were too long.
+ */
+uint32_t COMMS_Dropped(void);
+
+#endif // COMMS_H
@@ -4,7 +4,8 @@
  *
  * Provides initialization and control functions for a DRV8825 motor driver
  * with configurable pin mappings. Supports direction control, step pulses,
- * microstepping, and fault checking.
+ * microstepping, and fault checking. Multi-step moves are pulsed from a
+ * hardware timer ISR so they run in the background.
  *
  * @author  Rafael Delwart
  * @date    10 Apr 2025 adapted for ESP 13 May 2025
@@ -12,10 +13,101 @@
 
  #include <Arduino.h>
  #include "DRV8825.h"
+ #include "MOTION_PROFILE.h"
+ #include "FAST_GPIO.h"
  #include "send_functions.h"
  
 //  #define DRV8825_TEST
+
+ // === Background Step Engine State ===
+
+ static DRV8825_Channel_t channels[DRV8825_MAX_MOTORS];
+ static int channelCount = 0;
+ static void (*idleHook)(void) = NULL;
+
+ /**
+  * @brief Stops the step timer and releases the driver (ISR safe).
+  */
+ static void IRAM_ATTR DRV8825_Finish_ISR(DRV8825_Channel_t *ch) {
+   timerAlarmDisable(ch->timer);
+   DRV8825_Runtime_Pins::Release(ch);
+   ch->stepHigh = false;
+   ch->busy = false;
+ }
+
+ /**
+  * @brief FAULT pin interrupt: aborts the running move at the current step.
+  */
+ static void IRAM_ATTR DRV8825_Fault_ISR(void *arg) {
+   DRV8825_Channel_t *ch = (DRV8825_Channel_t *)arg;
+   if (!ch->busy) return;
+
+   ch->faultHit = true;  // Before busy drops, as in DRV8825_Halt_From_ISR()
+   DRV8825_Finish_ISR(ch);
+ }
+
+ // Arduino timer callbacks take no argument, so each timer gets a trampoline.
+ // Motors declared through the DRV8825<> template replace these with a
+ // specialized ISR (see DRV8825_Attach_Timer_ISR).
+ static void IRAM_ATTR onStepTimer0() { DRV8825_Timer_ISR<DRV8825_Runtime_Pins>(&channels[0]); }
+ static void IRAM_ATTR onStepTimer1() { DRV8825_Timer_ISR<DRV8825_Runtime_Pins>(&channels[1]); }
+
+ static void (*const timerCallbacks[DRV8825_MAX_MOTORS])(void) = {onStepTimer0, onStepTimer1};
+
+ /**
+  * @brief Finds the engine channel for a motor, or NULL if it was never initialized.
+  */
+ static DRV8825_Channel_t *IRAM_ATTR DRV8825_Find_Channel(const DRV8825_t *motor) {
+   for (int i = 0; i < channelCount; i++) {
+     if (channels[i].motor == motor) return &channels[i];
+   }
+   return NULL;
+ }
+
+ /**
+  * @brief Assigns a hardware timer to the motor the first time it is initialized.
+  */
+ static void DRV8825_Register_Channel(DRV8825_t *motor) {
+   if (DRV8825_Find_Channel(motor)) return;  // Already registered (Init called again)
+   if (channelCount >= DRV8825_MAX_MOTORS) {
+     Serial.println("[DRV8825] No free step timer for motor");
+     return;
+   }
+
+   DRV8825_Channel_t *ch = &channels[channelCount];
+   ch->motor = motor;
+   ch->stepsDone = 0;
+   ch->stepHigh = false;
+   ch->busy = false;
+   ch->limitHit = false;
+   ch->faultHit = false;
+   ch->direction = DRV8825_FORWARD;
+   ch->stepMask = FAST_GPIO_Mask(motor->step_pin);
+   ch->enableMask = FAST_GPIO_Mask(motor->enable_pin);
+   ch->timer = timerBegin(channelCount, DRV8825_TIMER_DIVIDER, true);
+   timerAttachInterrupt(ch->timer, timerCallbacks[channelCount], true);
+   attachInterruptArg(digitalPinToInterrupt(motor->fault_pin), DRV8825_Fault_ISR, ch, FALLING);  // FAULT is active-low
+   channelCount++;
+ }
  
+ /**
+  * @brief Returns the step engine channel of an initialized motor.
+  */
+ DRV8825_Channel_t *DRV8825_Get_Channel(const DRV8825_t *motor) {
+   return DRV8825_Find_Channel(motor);
+ }
+
+ /**
+  * @brief Replaces the motor's step timer ISR.
+  */
+ void DRV8825_Attach_Timer_ISR(const DRV8825_t *motor, void (*isr)(void)) {
+   DRV8825_Channel_t *ch = DRV8825_Find_Channel(motor);
+   if (!ch || ch->busy) return;
+
+   timerDetachInterrupt(ch->timer);
+   timerAttachInterrupt(ch->timer, isr, true);
+ }
+
  /**
   * @brief Initializes all GPIO pins used by the DRV8825 motor driver.
   *        This function must be called before any motor movement.
@@ -37,6 +129,8 @@
    digitalWrite(motor->dir_pin, DRV8825_FORWARD);
    DRV8825_Disable(motor);  // Ensure motor starts disabled
 
+   DRV8825_Register_Channel(motor);
+
    if (DRV8825_Check_Fault(motor)) {
      sendSystemError(ERROR_DRV8825_FAULT);
    }
@@ -56,14 +150,14 @@
   * @brief Enables the motor driver (logic LOW = enabled).
   */
  void DRV8825_Enable(DRV8825_t *motor) {
-   digitalWrite(motor->enable_pin, LOW);  // Active-low enable
+   FAST_GPIO_Write_Pin(motor->enable_pin, LOW);  // Active-low enable
  }
  
  /**
   * @brief Disables the motor driver (logic HIGH = disabled).
   */
  void DRV8825_Disable(DRV8825_t *motor) {
-   digitalWrite(motor->enable_pin, HIGH);
+   FAST_GPIO_Write_Pin(motor->enable_pin, HIGH);
  }
  
  /**
@@ -71,10 +165,13 @@
   *        HIGH for forward, LOW for backward.
   */
  void DRV8825_Set_Direction(DRV8825_t *motor, int direction) {
+   DRV8825_Channel_t *ch = DRV8825_Find_Channel(motor);
+   if (ch && !ch->busy) ch->direction = direction;  // Remembered for limit checks
+
    if (direction == DRV8825_FORWARD) {
-     digitalWrite(motor->dir_pin, HIGH);
+     FAST_GPIO_Write_Pin(motor->dir_pin, HIGH);
    } else if (direction == DRV8825_BACKWARD) {
-     digitalWrite(motor->dir_pin, LOW);
+     FAST_GPIO_Write_Pin(motor->dir_pin, LOW);
    } else {
      Serial.println("[DRV8825] Invalid direction");
    }
@@ -85,37 +182,71 @@
   *        Each HIGH-LOW cycle advances the motor one microstep.
   */
  void DRV8825_Step(DRV8825_t *motor) {
+   FAST_GPIO_MASK_t step = FAST_GPIO_Mask(motor->step_pin);
+
    // Drive step pin HIGH briefly
-   digitalWrite(motor->step_pin, HIGH);
+   FAST_GPIO_Set(&step);
    delayMicroseconds(2);  // DRV8825 min pulse: 1.9 µs
  
    // Drive step pin LOW to complete the pulse
-   digitalWrite(motor->step_pin, LOW);
+   FAST_GPIO_Clear(&step);
    delayMicroseconds(2);  // DRV8825 min low time: 1.9 µs
  }
  
+ /**
+  * @brief Returns the motor's channel if it is ready to start a new move.
+  */
+ static DRV8825_Channel_t *DRV8825_Claim_Channel(DRV8825_t *motor) {
+   DRV8825_Channel_t *ch = DRV8825_Find_Channel(motor);
+   if (!ch) {
+     Serial.println("[DRV8825] Motor not initialized");
+     return NULL;
+   }
+   if (ch->busy) {
+     Serial.println("[DRV8825] Motor busy, move rejected");
+     return NULL;
+   }
+   return ch;
+ }
+
+ /**
+  * @brief Arms the channel's timer to run ch->plan in the last set direction.
+  *        A driver already in fault never starts; the move ends as a
+  *        fault at step 0 (the FAULT edge has already passed).
+  */
+ static void DRV8825_Start(DRV8825_Channel_t *ch) {
+   ch->stepsDone = 0;
+   ch->stepHigh = false;
+   ch->limitHit = false;
+   ch->faultHit = DRV8825_Check_Fault(ch->motor);
+   if (ch->faultHit) return;
+
+   DRV8825_Enable(ch->motor);  // Enable motor driver
+   ch->busy = true;
+
+   timerWrite(ch->timer, 0);
+   timerAlarmWrite(ch->timer, DRV8825_Half_Period(&ch->plan, 0), true);
+   timerAlarmEnable(ch->timer);
+ }
+
  /**
   * @brief Sends multiple step pulses with delays between each.
   *        Useful for basic movement without acceleration control.
   *
+  *        Pulses are generated in the background by the step timer; this
+  *        call waits for them while running the idle hook.
+  *
   * @param steps     Number of pulses to send (microsteps).
   * @param delay_us  Time between steps (controls speed).
   */
  void DRV8825_Step_N(DRV8825_t *motor, int steps, int delay_us) {
-   DRV8825_Enable(motor);  // Enable motor driver
- 
-   for (int i = 0; i < steps; i++) {
-     // Stop if fault is detected
-    //  if (DRV8825_Check_Fault(motor)) {
-    //    Serial.printf("[DRV8825] Fault detected at step %d\n", i);
-    //    break;
-    //  }
- 
-     DRV8825_Step(motor);         // Send one step pulse
-     delayMicroseconds(delay_us); // Wait before next pulse
-   }
- 
-   DRV8825_Disable(motor);  // Disable motor to conserve power
+   DRV8825_Channel_t *ch = DRV8825_Claim_Channel(motor);
+   if (!ch || steps <= 0) return;
+
+   // Same period as the old bit-banged loop: 2 us HIGH + 2 us LOW + delay
+   MOTION_PROFILE_Constant(&ch->plan, steps, delay_us + 2 * DRV8825_MIN_PULSE_US);
+   DRV8825_Start(ch);
+   DRV8825_Wait(motor);
  }
  
  /**
@@ -127,16 +258,164 @@
     DRV8825_Step_N(motor, steps, delay_us);       // Execute movement
  }
  
+ /**
+  * @brief Starts a constant-speed background move and returns immediately.
+  */
+ bool DRV8825_Move_Async(DRV8825_t *motor, int steps, int direction, int delay_us) {
+   DRV8825_Channel_t *ch = DRV8825_Claim_Channel(motor);
+   if (!ch) return false;
+   if (steps <= 0) return true;
+
+   DRV8825_Set_Direction(motor, direction);
+   MOTION_PROFILE_Constant(&ch->plan, steps, delay_us + 2 * DRV8825_MIN_PULSE_US);
+   DRV8825_Start(ch);
+   return true;
+ }
+
+ /**
+  * @brief Starts an accelerated background move and returns immediately.
+  *        The ramp is planned here, before the timer is armed.
+  */
+ bool DRV8825_Move_Profile_Async(DRV8825_t *motor, int steps, int direction, const MOTION_PROFILE_t *profile) {
+   DRV8825_Channel_t *ch = DRV8825_Claim_Channel(motor);
+   if (!ch) return false;
+   if (steps <= 0) return true;
+
+   DRV8825_Set_Direction(motor, direction);
+   MOTION_PROFILE_Plan(&ch->plan, steps, profile);
+   DRV8825_Start(ch);
+   return true;
+ }
+
+ /**
+  * @brief Starts a move toward a limit switch and returns immediately.
+  *        The move is expected to be cut short by DRV8825_Halt_From_ISR();
+  *        if it is not, it decelerates and ends at max_steps.
+  */
+ bool DRV8825_Move_Until_Limit_Async(DRV8825_t *motor, int max_steps, int direction, const MOTION_PROFILE_t *profile) {
+   DRV8825_Channel_t *ch = DRV8825_Claim_Channel(motor);
+   if (!ch) return false;
+   if (max_steps <= 0) return true;
+
+   MOTION_PROFILE_Plan(&ch->plan, max_steps, profile);
+   DRV8825_Set_Direction(motor, direction);
+   DRV8825_Start(ch);
+   return true;
+ }
+
+ /**
+  * @brief Runs a move toward a limit switch and waits for it to end.
+  */
+ bool DRV8825_Move_Until_Limit(DRV8825_t *motor, int max_steps, int direction, const MOTION_PROFILE_t *profile) {
+   if (!DRV8825_Move_Until_Limit_Async(motor, max_steps, direction, profile)) return false;
+   DRV8825_Wait(motor);
+   return DRV8825_Limit_Hit(motor);
+ }
+
+ /**
+  * @brief Stops the motor from a limit switch ISR if it is moving toward that limit.
+  */
+ void IRAM_ATTR DRV8825_Halt_From_ISR(DRV8825_t *motor, int direction) {
+   DRV8825_Channel_t *ch = DRV8825_Find_Channel(motor);
+   if (!ch || !ch->busy || ch->direction != direction) return;
+
+   ch->limitHit = true;  // Before busy drops: a waiter that sees the move end must see why
+   DRV8825_Finish_ISR(ch);
+ }
+
+ /**
+  * @brief Returns true if the last move ended at a limit switch.
+  */
+ bool DRV8825_Limit_Hit(DRV8825_t *motor) {
+   DRV8825_Channel_t *ch = DRV8825_Find_Channel(motor);
+   return ch && ch->limitHit;
+ }
+
+ /**
+  * @brief Returns true if the last move was aborted by the FAULT interrupt.
+  */
+ bool DRV8825_Fault_Hit(DRV8825_t *motor) {
+   DRV8825_Channel_t *ch = DRV8825_Find_Channel(motor);
+   return ch && ch->faultHit;
+ }
+
+ /**
+  * @brief Runs an accelerated move and waits for it to finish.
+  */
+ void DRV8825_Move_Profile(DRV8825_t *motor, int steps, int direction, const MOTION_PROFILE_t *profile) {
+   if (DRV8825_Move_Profile_Async(motor, steps, direction, profile)) {
+     DRV8825_Wait(motor);
+   }
+ }
+
+ /**
+  * @brief Returns true while the step timer is still sending pulses.
+  */
+ bool DRV8825_Is_Busy(DRV8825_t *motor) {
+   DRV8825_Channel_t *ch = DRV8825_Find_Channel(motor);
+   return ch && ch->busy;
+ }
+
+ /**
+  * @brief Waits for the background move to finish, servicing the idle hook.
+  */
+ void DRV8825_Wait(DRV8825_t *motor) {
+   while (DRV8825_Is_Busy(motor)) {
+     DRV8825_Idle();
+   }
+ }
+
+ /**
+  * @brief Runs the idle hook once and yields to the WiFi stack.
+  */
+ void DRV8825_Idle() {
+   if (idleHook) idleHook();
+   yield();
+ }
+
+ /**
+  * @brief Stops the background move and disables the driver.
+  */
+ void DRV8825_Abort(DRV8825_t *motor) {
+   DRV8825_Channel_t *ch = DRV8825_Find_Channel(motor);
+   if (!ch) return;
+
+   DRV8825_Finish_ISR(ch);
+ }
+
+ /**
+  * @brief Returns the number of pulses completed by the current/last move.
+  */
+ uint32_t DRV8825_Get_Steps_Done(DRV8825_t *motor) {
+   DRV8825_Channel_t *ch = DRV8825_Find_Channel(motor);
+   return ch ? ch->stepsDone : 0;
+ }
+
+ /**
+  * @brief Sets the function DRV8825_Wait() runs while a move is in progress.
+  */
+ void DRV8825_Set_Idle_Hook(void (*hook)(void)) {
+   idleHook = hook;
+ }
+
  /**
   * @brief Configures the microstepping mode by setting MODE0–2 pins.
   *        Values range from 0 (full step) to 7 (1/32 step).
   *
-  *        Mode pins are binary-coded: MODE2:MODE1:MODE0
+  *        Mode pins are binary-coded: MODE2:MODE1:MODE0. The change is
+  *        not atomic: the pins going HIGH are set one store before the
+  *        pins going LOW are cleared. Only call it with the motor at
+  *        rest; the DRV8825 latches the mode on the next STEP edge, so
+  *        the mixed mode in between is never used.
   */
  void DRV8825_Set_Step_Mode(DRV8825_t *motor, int mode) {
-   digitalWrite(motor->mode0_pin, mode & 0x01);         // LSB
-   digitalWrite(motor->mode1_pin, (mode >> 1) & 0x01);  // Mid
-   digitalWrite(motor->mode2_pin, (mode >> 2) & 0x01);  // MSB
+   const int pins[3] = {motor->mode0_pin, motor->mode1_pin, motor->mode2_pin};  // LSB..MSB
+   FAST_GPIO_MASK_t high = {0, 0};
+   FAST_GPIO_MASK_t low = {0, 0};
+   for (int bit = 0; bit < 3; bit++) {
+     FAST_GPIO_Add(((mode >> bit) & 0x01) ? &high : &low, pins[bit]);
+   }
+   FAST_GPIO_Write(&high, &low);
  }
  
  
@@ -14,6 +14,11 @@
  #define DRV8825_H
  
  #include <Arduino.h>
+ #include "MOTION_PROFILE.h"
+ #include "FAST_GPIO.h"
+ #ifdef DRV8825_BENCH
+ #include "DRV8825_BENCH.h"
+ #endif
  
  // === Direction Constants ===
  #define DRV8825_FORWARD  1
@@ -21,7 +26,12 @@
  
  // === Default Step Delay (us) ===
  #define DRV8825_DEFAULT_STEP_DELAY_US 1000
- 
+
+ // === Background Step Engine ===
+ #define DRV8825_MAX_MOTORS      2   // One hardware timer per motor (timers 0..N-1)
+ #define DRV8825_TIMER_DIVIDER   80  // 80 MHz APB / 80 = 1 tick per us
+ #define DRV8825_MIN_PULSE_US    2   // DRV8825 min high/low time: 1.9 us
+
  // === Microstepping Modes (MODE2:MODE1:MODE0 binary format) ===
  #define DRV8825_FULL_STEP          0  // 000
  #define DRV8825_HALF_STEP          1  // 001
@@ -48,6 +58,88 @@
    int mode2_pin;   ///< Pin for microstepping mode bit 2
    int enable_pin;  ///< Pin used to enable/disable motor driver (active-low)
  } DRV8825_t;
+
+ // === Background Step Engine ===
+
+ /**
+  * @struct DRV8825_Channel_t
+  * @brief  Per-motor state for the timer-driven step generator.
+  *
+  * Each initialized motor owns one hardware timer. The timer fires every
+  * half step period and the ISR toggles the STEP pin, so a pulse is one
+  * HIGH interrupt followed by one LOW interrupt. The driver steps on the
+  * rising edge, so that is where a step is counted.
+  */
+ typedef struct {
+   DRV8825_t *motor;                  ///< Motor this channel drives
+   hw_timer_t *timer;                 ///< Hardware timer generating the pulses
+   volatile uint32_t stepsDone;       ///< Rising edges sent in the current move
+   volatile bool stepHigh;            ///< STEP pin currently HIGH
+   volatile bool busy;                ///< Move in progress
+   volatile bool limitHit;            ///< Last move was stopped by DRV8825_Halt_From_ISR()
+   volatile bool faultHit;            ///< Last move was stopped by the FAULT pin interrupt
+   int direction;                     ///< Direction of the current move
+   FAST_GPIO_MASK_t stepMask;         ///< STEP pin, for register writes from the ISR
+   FAST_GPIO_MASK_t enableMask;       ///< ENABLE pin
+   MOTION_PLAN_t plan;                ///< Step periods for the current move
+ } DRV8825_Channel_t;
+
+ /**
+  * @brief Timer alarm (half a step period) for step `step` of a plan.
+  */
+ static inline uint32_t IRAM_ATTR DRV8825_Half_Period(const MOTION_PLAN_t *plan, uint32_t step) {
+   uint32_t half = MOTION_PROFILE_Interval(plan, step) / 2;
+   return half < DRV8825_MIN_PULSE_US ? DRV8825_MIN_PULSE_US : half;
+ }
+
+ /**
+  * @brief Pin access for motors configured at run time: masks are read
+  *        from the channel.
+  */
+ struct DRV8825_Runtime_Pins {
+   static inline void IRAM_ATTR Step_High(DRV8825_Channel_t *ch) { FAST_GPIO_Set(&ch->stepMask); }
+   static inline void IRAM_ATTR Step_Low(DRV8825_Channel_t *ch) { FAST_GPIO_Clear(&ch->stepMask); }
+   /// STEP LOW and driver disabled (ENABLE HIGH) at the end of a move
+   static inline void IRAM_ATTR Release(DRV8825_Channel_t *ch) {
+     FAST_GPIO_Clear(&ch->stepMask);
+     FAST_GPIO_Set(&ch->enableMask);
+   }
+ };
+
+ /**
+  * @brief Step timer ISR body: toggles STEP and ends the move on the last pulse.
+  *
+  * `Pins` supplies Step_High/Step_Low/Release. With DRV8825_Runtime_Pins
+  * the masks come from the channel; with a DRV8825<> specialization they are
+  * compile-time constants and each call is a single register store.
+  */
+ template <class Pins>
+ static inline void IRAM_ATTR DRV8825_Timer_ISR(DRV8825_Channel_t *ch) {
+   if (!ch->busy) return;  // Halted by a limit ISR between alarms
+
+   if (!ch->stepHigh) {
+     Pins::Step_High(ch);  // Rising edge: driver takes the step
+ #ifdef DRV8825_BENCH
+     DRV8825_BENCH_Stamp();
+ #endif
+     ch->stepHigh = true;
+     ch->stepsDone++;
+     return;
+   }
+
+   Pins::Step_Low(ch);
+   ch->stepHigh = false;
+
+   if (ch->stepsDone >= ch->plan.totalSteps) {
+     timerAlarmDisable(ch->timer);
+     Pins::Release(ch);  // Disable driver to conserve power
+     ch->busy = false;
+     return;
+   }
+
+   // Load the period of the next step from the plan (ramps up/down)
+   timerAlarmWrite(ch->timer, DRV8825_Half_Period(&ch->plan, ch->stepsDone), true);
+ }
  
  // === API Function Prototypes ===
  
@@ -116,7 +208,133 @@
   * @param delay_us Delay in microseconds between steps
   */
  void DRV8825_Move(DRV8825_t *motor, int steps, int direction, int delay_us);
- 
+
+ /**
+  * Starts a move that runs in the background on the motor's hardware timer.
+  * Returns immediately; the step pulses are generated from the timer ISR and
+  * the driver is disabled again when the last pulse has been sent.
+  *
+  * @param motor Pointer to DRV8825_t struct (must have been passed to DRV8825_Init)
+  * @param steps Number of steps to move
+  * @param direction DRV8825_FORWARD or DRV8825_BACKWARD
+  * @param delay_us Delay in microseconds between steps
+  * @return true if the move was started, false if the motor is busy or unknown
+  */
+ bool DRV8825_Move_Async(DRV8825_t *motor, int steps, int direction, int delay_us);
+
+ /**
+  * Moves the motor with an acceleration ramp and waits for it to finish.
+  * Step periods come from MOTION_PROFILE_Plan(), so the axis starts at
+  * profile->start_speed, cruises at profile->max_speed and slows down
+  * symmetrically before the last step.
+  *
+  * @param motor Pointer to DRV8825_t struct
+  * @param steps Number of steps to move
+  * @param direction DRV8825_FORWARD or DRV8825_BACKWARD
+  * @param profile Axis speed/acceleration/jerk limits
+  */
+ void DRV8825_Move_Profile(DRV8825_t *motor, int steps, int direction, const MOTION_PROFILE_t *profile);
+
+ /**
+  * Background version of DRV8825_Move_Profile(); returns immediately.
+  *
+  * @return true if the move was started, false if the motor is busy or unknown
+  */
+ bool DRV8825_Move_Profile_Async(DRV8825_t *motor, int steps, int direction, const MOTION_PROFILE_t *profile);
+
+ /**
+  * Starts a move toward a limit switch and returns immediately.
+  * The axis ramps up with `profile` and keeps going until the limit switch
+  * ISR calls DRV8825_Halt_From_ISR(), or until max_steps have been sent.
+  *
+  * @param motor Pointer to DRV8825_t struct
+  * @param max_steps Safety cap on the number of steps
+  * @param direction DRV8825_FORWARD or DRV8825_BACKWARD
+  * @param profile Axis speed/acceleration/jerk limits
+  * @return true if the move was started, false if the motor is busy or unknown
+  */
+ bool DRV8825_Move_Until_Limit_Async(DRV8825_t *motor, int max_steps, int direction, const MOTION_PROFILE_t *profile);
+
+ /**
+  * Blocking version of DRV8825_Move_Until_Limit_Async().
+  * Use DRV8825_Get_Steps_Done() afterwards for the exact travel.
+  *
+  * @return true if the limit was hit, false if max_steps ran out first
+  */
+ bool DRV8825_Move_Until_Limit(DRV8825_t *motor, int max_steps, int direction, const MOTION_PROFILE_t *profile);
+
+ /**
+  * Stops pulse generation from inside a limit switch ISR.
+  * Only acts if the motor is currently moving in `direction`, so a switch
+  * on one end never blocks a move away from it.
+  *
+  * @param motor Pointer to DRV8825_t struct
+  * @param direction Direction the limit switch guards
+  */
+ void IRAM_ATTR DRV8825_Halt_From_ISR(DRV8825_t *motor, int direction);
+
+ /**
+  * Returns true if the last move was stopped by DRV8825_Halt_From_ISR().
+  *
+  * @param motor Pointer to DRV8825_t struct
+  */
+ bool DRV8825_Limit_Hit(DRV8825_t *motor);
+
+ /**
+  * Returns true if the last move was aborted because the driver pulled its
+  * FAULT line low (overcurrent, overtemperature, undervoltage).
+  * DRV8825_Get_Steps_Done() then gives the step it stopped at.
+  *
+  * The FAULT pin is watched by an edge interrupt, so this costs nothing
+  * per step.
+  *
+  * @param motor Pointer to DRV8825_t struct
+  */
+ bool DRV8825_Fault_Hit(DRV8825_t *motor);
+
+ /**
+  * Returns true while a background move is still generating pulses.
+  *
+  * @param motor Pointer to DRV8825_t struct
+  */
+ bool DRV8825_Is_Busy(DRV8825_t *motor);
+
+ /**
+  * Waits for the current background move to finish.
+  * The idle hook (see DRV8825_Set_Idle_Hook) is called repeatedly while waiting
+  * so networking and heater control keep running during long moves.
+  *
+  * @param motor Pointer to DRV8825_t struct
+  */
+ void DRV8825_Wait(DRV8825_t *motor);
+
+ /**
+  * Stops the current background move immediately and disables the driver.
+  *
+  * @param motor Pointer to DRV8825_t struct
+  */
+ void DRV8825_Abort(DRV8825_t *motor);
+
+ /**
+  * Returns the number of steps sent by the current (or last) background move.
+  *
+  * @param motor Pointer to DRV8825_t struct
+  */
+ uint32_t DRV8825_Get_Steps_Done(DRV8825_t *motor);
+
+ /**
+  * Registers a function that DRV8825_Wait() calls while a move is running.
+  *
+  * @param hook Function to call, or NULL to only yield()
+  */
+ void DRV8825_Set_Idle_Hook(void (*hook)(void));
+
+ /**
+  * Runs the idle hook once, then yields. For other code that waits on
+  * motion (e.g. the motion scheduler) so it services the same work.
+  */
+ void DRV8825_Idle(void);
+
  /**
   * Sets the microstepping mode of the driver by setting MODE0–2 pins.
   *
@@ -124,6 +342,111 @@
   * @param mode Integer from 0 to 7 representing MODE2:MODE1:MODE0 bits
   */
  void DRV8825_Set_Step_Mode(DRV8825_t *motor, int mode);
+
+ /**
+  * Returns the step engine channel of a motor, or NULL if DRV8825_Init()
+  * has not been called for it.
+  *
+  * @param motor Pointer to DRV8825_t struct
+  */
+ DRV8825_Channel_t *DRV8825_Get_Channel(const DRV8825_t *motor);
+
+ /**
+  * Replaces the step timer ISR of an initialized, idle motor.
+  * Used by DRV8825<>::Init() to install its specialized ISR.
+  *
+  * @param motor Pointer to DRV8825_t struct
+  * @param isr Timer callback that calls DRV8825_Timer_ISR() for this motor
+  */
+ void DRV8825_Attach_Timer_ISR(const DRV8825_t *motor, void (*isr)(void));
+
+ // === Compile-Time Pin Configuration ===
+
+ /**
+  * @brief DRV8825 with its pin mapping fixed at compile time.
+  *
+  * All pin masks are constants, so the step ISR installed by Init() and the
+  * pin helpers below compile down to plain GPIO register stores. Config()
+  * gives the matching DRV8825_t, so the DRV8825_* functions, MOTION and the
+  * limit ISRs keep using the same motor struct.
+  *
+  * @code
+  * typedef DRV8825<6, 7, 15, 16, 17, 18, 8> MovementDriver;
+  * DRV8825_t movementMotor = MovementDriver::Config();
+  * MovementDriver::Init(&movementMotor);
+  * @endcode
+  */
+ template <int STEP, int DIR, int FAULT, int MODE0, int MODE1, int MODE2, int ENABLE>
+ struct DRV8825 {
+   /// Register mask of one pin: bank 0 (GPIO 0-31) or bank 1 (GPIO 32+)
+   static constexpr uint32_t Low(int pin) { return pin < 32 ? (1UL << pin) : 0; }
+   static constexpr uint32_t High(int pin) { return pin < 32 ? 0 : (1UL << (pin - 32)); }
+
+   /// Runtime struct with the same pins, for the C-style DRV8825_* API
+   static constexpr DRV8825_t Config() {
+     return DRV8825_t{STEP, DIR, FAULT, MODE0, MODE1, MODE2, ENABLE};
+   }
+
+   /// Same step ops as DRV8825_Runtime_Pins; the channel is not needed, the pins are constants
+   static inline void IRAM_ATTR Step_High(DRV8825_Channel_t * = NULL) {
+     const FAST_GPIO_MASK_t mask = {Low(STEP), High(STEP)};
+     FAST_GPIO_Set(&mask);
+   }
+
+   static inline void IRAM_ATTR Step_Low(DRV8825_Channel_t * = NULL) {
+     const FAST_GPIO_MASK_t mask = {Low(STEP), High(STEP)};
+     FAST_GPIO_Clear(&mask);
+   }
+
+   static inline void IRAM_ATTR Release(DRV8825_Channel_t * = NULL) {
+     Step_Low();
+     Disable();
+   }
+
+   static inline void IRAM_ATTR Enable() {
+     const FAST_GPIO_MASK_t mask = {Low(ENABLE), High(ENABLE)};
+     FAST_GPIO_Clear(&mask);  // Active-low enable
+   }
+
+   static inline void IRAM_ATTR Disable() {
+     const FAST_GPIO_MASK_t mask = {Low(ENABLE), High(ENABLE)};
+     FAST_GPIO_Set(&mask);
+   }
+
+   static inline void Set_Direction(int direction) {
+     const FAST_GPIO_MASK_t mask = {Low(DIR), High(DIR)};
+     if (direction == DRV8825_FORWARD) FAST_GPIO_Set(&mask);
+     else FAST_GPIO_Clear(&mask);
+   }
+
+   /// MODE2:MODE1:MODE0 in one set/clear pair (not atomic; motor at rest only)
+   static inline void Set_Step_Mode(int mode) {
+     const FAST_GPIO_MASK_t all = {Low(MODE0) | Low(MODE1) | Low(MODE2), High(MODE0) | High(MODE1) | High(MODE2)};
+     FAST_GPIO_MASK_t high = {0, 0};
+     if (mode & 0x01) { high.low |= Low(MODE0); high.high |= High(MODE0); }
+     if (mode & 0x02) { high.low |= Low(MODE1); high.high |= High(MODE1); }
+     if (mode & 0x04) { high.low |= Low(MODE2); high.high |= High(MODE2); }
+     const FAST_GPIO_MASK_t low = {all.low & ~high.low, all.high & ~high.high};
+     FAST_GPIO_Write(&high, &low);
+   }
+
+   /// Initializes the motor (DRV8825_Init) and installs the specialized step ISR
+   static void Init(DRV8825_t *motor) {
+     DRV8825_Init(motor);
+     channel = DRV8825_Get_Channel(motor);
+     if (channel) DRV8825_Attach_Timer_ISR(motor, Timer_ISR);
+   }
+
+  private:
+   static DRV8825_Channel_t *channel;  ///< Engine channel of this motor, set by Init()
+
+   static void IRAM_ATTR Timer_ISR() {
+     DRV8825_Timer_ISR<DRV8825>(channel);
+   }
+ };
+
+ template <int STEP, int DIR, int FAULT, int MODE0, int MODE1, int MODE2, int ENABLE>
+ DRV8825_Channel_t *DRV8825<STEP, DIR, FAULT, MODE0, MODE1, MODE2, ENABLE>::channel = NULL;
  
  #endif  // DRV8825_H
  
\ No newline at end of file
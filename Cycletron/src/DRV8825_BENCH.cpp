@@ -0,0 +1,406 @@
+/**
+ * @file    DRV8825_BENCH.cpp
+ * @brief   Step rate and jitter benchmark for the DRV8825 step engine
+ *
+ * Sweeps microstep mode and step delay, runs DRV8825_BENCH_SAMPLES steps
+ * per point and times every rising STEP edge from inside the step ISR
+ * (see DRV8825_BENCH.h). Each point reports the planned and achieved step
+ * rate, the step interval jitter percentiles and the largest lag of any
+ * edge behind its ideal time. The sweep runs twice: once quiet and once
+ * under radio load, to see what WiFi interrupts cost.
+ *
+ * The sweep drives the carriage motor. Points alternate direction so the
+ * carriage stays near where it started, and both bumpers halt it from
+ * their ISRs as in MOVEMENT.cpp; a point cut short by a bumper is run
+ * again the other way.
+ *
+ * Build with `pio run -e bench` for the board (motor may be disconnected;
+ * output on Serial) or `pio run -e native_bench` for the host, where the
+ * simulated timer backend makes the quiet sweep exact and the run exits
+ * non-zero if the engine misses its planned rate or loses steps. The host
+ * run also checks that MOTION's position bookkeeping follows the DRV8825
+ * indexer across step mode changes (simulated syringe axis).
+ *
+ * Date:   Oct 2026
+ */
+
+#ifdef DRV8825_BENCH
+
+#include <Arduino.h>
+#include "DRV8825.h"
+#include "DRV8825_BENCH.h"
+#include "MOTION_PROFILE.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <WiFi.h>
+#else
+#include "SIM_HAL.h"
+#include "SIM_BOARD.h"
+#include "MOTION.h"
+#endif
+
+// === Sweep ===
+static const int benchModes[] = {DRV8825_FULL_STEP, DRV8825_QUARTER_STEP, DRV8825_SIXTEENTH_STEP, DRV8825_THIRTYSECOND_STEP};
+static const int benchDelays[] = {1000, 500, 200, 100, 50, 20, 10, 5, 0}; // delay_us passed to DRV8825_Move_Async()
+
+#define BENCH_MODE_COUNT (sizeof(benchModes) / sizeof(benchModes[0]))
+#define BENCH_DELAY_COUNT (sizeof(benchDelays) / sizeof(benchDelays[0]))
+
+// === Host Regression Limits (quiet sweep on the simulated backend) ===
+#define BENCH_SIM_RATE_TOLERANCE 0.005f  // Achieved rate within 0.5% of planned
+#define BENCH_SIM_JITTER_NS 10           // Cycle/ns rounding only
+
+// === Simulated Radio Load ===
+#define BENCH_SIM_LATENCY_NS 20000       // Up to 20 us late...
+#define BENCH_SIM_LATENCY_PERCENT 2      // ...for 2% of interrupts
+
+/**
+ * @brief Background activity during a sweep.
+ */
+typedef enum
+{
+    BENCH_LOAD_QUIET, ///< Radio off
+    BENCH_LOAD_RADIO  ///< Continuous WiFi scanning (simulated: random ISR latency)
+} BENCH_LOAD_t;
+
+/**
+ * @struct BENCH_RESULT_t
+ * @brief  Figures for one sweep point.
+ */
+typedef struct
+{
+    uint32_t steps;        ///< Steps timed
+    uint32_t lost;         ///< Steps the engine reported but no stamp was taken for
+    float targetRate;      ///< Planned steps/s
+    float achievedRate;    ///< Measured steps/s over the timed steps
+    uint32_t p50Ns;        ///< Median |interval - planned interval|
+    uint32_t p99Ns;        ///< 99th percentile
+    uint32_t p999Ns;       ///< 99.9th percentile
+    uint32_t maxJitterNs;  ///< Worst single interval error
+    uint32_t maxLatencyNs; ///< Worst lag of an edge behind its ideal time
+} BENCH_RESULT_t;
+
+volatile uint32_t benchStamps[DRV8825_BENCH_SAMPLES];
+volatile uint32_t benchStampCount = 0;
+
+static uint32_t benchJitter[DRV8825_BENCH_SAMPLES];
+
+// Bench axis: the carriage (MOVEMENT.cpp wiring), specialized ISR as in the firmware
+typedef DRV8825<6, 7, 15, 16, 17, 18, 8> BenchDriver;
+static DRV8825_t benchMotor = BenchDriver::Config();
+#define BENCH_FRONT_BUMPER_PIN 3
+#define BENCH_BACK_BUMPER_PIN 10
+
+static void IRAM_ATTR BENCH_Front_Limit()
+{
+    DRV8825_Halt_From_ISR(&benchMotor, DRV8825_FORWARD);
+}
+
+static void IRAM_ATTR BENCH_Back_Limit()
+{
+    DRV8825_Halt_From_ISR(&benchMotor, DRV8825_BACKWARD);
+}
+
+/**
+ * @brief Starts the background load for a sweep.
+ */
+static void BENCH_Load_Start(BENCH_LOAD_t load)
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    if (load == BENCH_LOAD_RADIO)
+    {
+        WiFi.mode(WIFI_STA);
+        WiFi.scanNetworks(true);
+    }
+#else
+    if (load == BENCH_LOAD_RADIO)
+        SIM_Set_ISR_Latency(BENCH_SIM_LATENCY_NS, BENCH_SIM_LATENCY_PERCENT);
+#endif
+}
+
+/**
+ * @brief Keeps the load going while a move runs (restarts finished scans).
+ */
+static void BENCH_Load_Service(BENCH_LOAD_t load)
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    if (load == BENCH_LOAD_RADIO && WiFi.scanComplete() != WIFI_SCAN_RUNNING)
+    {
+        WiFi.scanDelete();
+        WiFi.scanNetworks(true);
+    }
+#else
+    (void)load;
+#endif
+    yield();
+}
+
+/**
+ * @brief Stops the background load.
+ */
+static void BENCH_Load_Stop(BENCH_LOAD_t load)
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    if (load == BENCH_LOAD_RADIO)
+    {
+        WiFi.scanDelete();
+        WiFi.mode(WIFI_OFF);
+    }
+#else
+    (void)load;
+    SIM_Set_ISR_Latency(0, 0);
+#endif
+}
+
+static int BENCH_Compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Cycle counter difference in nanoseconds.
+ */
+static uint64_t BENCH_Cycles_To_Ns(uint32_t cycles)
+{
+    return (uint64_t)cycles * 1000ULL / getCpuFrequencyMhz();
+}
+
+/**
+ * @brief Runs one sweep point and analyses its stamps.
+ *
+ * @return false if the move could not be started
+ */
+static bool BENCH_Run_Point(BENCH_LOAD_t load, int mode, int delayUs, int direction, BENCH_RESULT_t *result)
+{
+    // Same period the engine plans for DRV8825_Move_Async()
+    MOTION_PLAN_t plan;
+    MOTION_PROFILE_Constant(&plan, DRV8825_BENCH_SAMPLES, delayUs + 2 * DRV8825_MIN_PULSE_US);
+    uint64_t expectedNs = 2ULL * DRV8825_Half_Period(&plan, 0) * 1000ULL;
+
+    DRV8825_Set_Step_Mode(&benchMotor, mode);
+    benchStampCount = 0;
+    if (!DRV8825_Move_Async(&benchMotor, DRV8825_BENCH_SAMPLES, direction, delayUs))
+        return false;
+    while (DRV8825_Is_Busy(&benchMotor))
+        BENCH_Load_Service(load);
+
+    uint32_t n = benchStampCount;
+    result->steps = n;
+    result->lost = DRV8825_Get_Steps_Done(&benchMotor) - n;
+    result->targetRate = 1e9f / (float)expectedNs;
+    result->achievedRate = 0;
+    result->p50Ns = result->p99Ns = result->p999Ns = 0;
+    result->maxJitterNs = result->maxLatencyNs = 0;
+    if (n < 2)
+        return true;
+
+    int64_t maxLatency = 0;
+    for (uint32_t i = 1; i < n; i++)
+    {
+        int64_t interval = (int64_t)BENCH_Cycles_To_Ns(benchStamps[i] - benchStamps[i - 1]);
+        int64_t error = interval - (int64_t)expectedNs;
+        benchJitter[i - 1] = (uint32_t)(error < 0 ? -error : error);
+
+        int64_t lag = (int64_t)BENCH_Cycles_To_Ns(benchStamps[i] - benchStamps[0]) - (int64_t)(i * expectedNs);
+        if (lag > maxLatency)
+            maxLatency = lag;
+    }
+
+    uint32_t intervals = n - 1;
+    qsort(benchJitter, intervals, sizeof(benchJitter[0]), BENCH_Compare);
+    result->p50Ns = benchJitter[(intervals - 1) * 500 / 1000];
+    result->p99Ns = benchJitter[(intervals - 1) * 990 / 1000];
+    result->p999Ns = benchJitter[(intervals - 1) * 999 / 1000];
+    result->maxJitterNs = benchJitter[intervals - 1];
+    result->maxLatencyNs = (uint32_t)maxLatency;
+
+    uint64_t totalNs = BENCH_Cycles_To_Ns(benchStamps[n - 1] - benchStamps[0]);
+    result->achievedRate = totalNs ? (float)((double)intervals * 1e9 / (double)totalNs) : 0;
+    return true;
+}
+
+/**
+ * @brief Checks a quiet host result against the exact simulated timer.
+ */
+static bool BENCH_Sim_Point_OK(const BENCH_RESULT_t *result)
+{
+    float error = (result->achievedRate - result->targetRate) / result->targetRate;
+    if (error < 0)
+        error = -error;
+    return result->steps == DRV8825_BENCH_SAMPLES && result->lost == 0 &&
+           error <= BENCH_SIM_RATE_TOLERANCE && result->maxJitterNs <= BENCH_SIM_JITTER_NS;
+}
+
+/**
+ * @brief Runs the full mode x delay sweep under one load.
+ *
+ * @return Number of points that failed (host quiet sweep only)
+ */
+static int BENCH_Sweep(BENCH_LOAD_t load)
+{
+    const char *loadName = (load == BENCH_LOAD_RADIO) ? "radio" : "quiet";
+    int failures = 0;
+    int direction = DRV8825_FORWARD;
+
+    BENCH_Load_Start(load);
+    for (size_t m = 0; m < BENCH_MODE_COUNT; m++)
+    {
+        for (size_t d = 0; d < BENCH_DELAY_COUNT; d++)
+        {
+            BENCH_RESULT_t r;
+            bool started = BENCH_Run_Point(load, benchModes[m], benchDelays[d], direction, &r);
+            if (started && DRV8825_Limit_Hit(&benchMotor))
+            {
+                // Cut short at a bumper: there is room the other way
+                Serial.printf("[BENCH] %s mode=%d delay=%d: bumper hit, running it in reverse\n", loadName, benchModes[m], benchDelays[d]);
+                direction = (direction == DRV8825_FORWARD) ? DRV8825_BACKWARD : DRV8825_FORWARD;
+                started = BENCH_Run_Point(load, benchModes[m], benchDelays[d], direction, &r);
+            }
+            direction = (direction == DRV8825_FORWARD) ? DRV8825_BACKWARD : DRV8825_FORWARD;
+            if (!started)
+            {
+                Serial.printf("[BENCH] %s mode=%d delay=%d: move rejected\n", loadName, benchModes[m], benchDelays[d]);
+                failures++;
+                continue;
+            }
+
+            bool ok = true;
+#if !defined(ARDUINO_ARCH_ESP32)
+            ok = (load != BENCH_LOAD_QUIET) || BENCH_Sim_Point_OK(&r);
+            if (!ok)
+                failures++;
+#endif
+            Serial.printf("%-5s %4d %6d %6lu %4lu %9.0f %9.0f %8lu %8lu %8lu %8lu %9lu%s\n",
+                          loadName, benchModes[m], benchDelays[d],
+                          (unsigned long)r.steps, (unsigned long)r.lost, r.targetRate, r.achievedRate,
+                          (unsigned long)r.p50Ns, (unsigned long)r.p99Ns, (unsigned long)r.p999Ns,
+                          (unsigned long)r.maxJitterNs, (unsigned long)r.maxLatencyNs, ok ? "" : "  FAIL");
+        }
+    }
+    BENCH_Load_Stop(load);
+    return failures;
+}
+
+#if !defined(ARDUINO_ARCH_ESP32)
+// === Indexer Phase Check (host only) ===
+// Syringe wiring from REHYDRATION.cpp; nothing else drives it in this build
+typedef DRV8825<1, 2, 42, 41, 40, 39, 38> BenchSyringeDriver;
+static DRV8825_t benchSyringe = BenchSyringeDriver::Config();
+#define BENCH_SYRINGE_BACK_BUMPER_PIN 9
+
+static const MOTION_PROFILE_t benchFineProfile = {.start_speed = 2000, .max_speed = 8000, .max_accel = 20000, .max_jerk = 0};
+static const MOTION_PROFILE_t benchCoarseProfile = {.start_speed = 250, .max_speed = 1500, .max_accel = 3000, .max_jerk = 0};
+
+static void IRAM_ATTR BENCH_Syringe_Back_Limit()
+{
+    DRV8825_Halt_From_ISR(&benchSyringe, DRV8825_BACKWARD);
+}
+
+/**
+ * @brief Runs one syringe move and compares MOTION's position with the plant.
+ *
+ * @return 1 if the move ended differently or the positions disagree
+ */
+static int BENCH_Phase_Move(const char *name, const MOTION_COMMAND_t *cmd, int32_t plantStart,
+                            MOTION_RESULT_t expectResult, uint32_t expectSteps)
+{
+    MOTION_EVENT_t event;
+    MOTION_RESULT_t result = MOTION_Wait(MOTION_Enqueue(MOTION_AXIS_SYRINGE, cmd), &event);
+    int32_t counted = MOTION_Get_Position(MOTION_AXIS_SYRINGE);
+    int32_t actual = SIM_AXIS_Position(simSyringeAxis) - plantStart;
+    bool ok = (result == expectResult) && (expectSteps == 0 || event.steps == expectSteps) && counted == actual;
+    Serial.printf("phase %-22s result %d steps %6lu counted %7ld actual %7ld%s\n", name, (int)result,
+                  (unsigned long)event.steps, (long)counted, (long)actual, ok ? "" : "  FAIL");
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Leaves the indexer between full steps, then runs adaptive moves
+ *        (lead-in, full-step travel, fine approach) in both directions.
+ *
+ * @return Number of failed checks
+ */
+static int BENCH_Phase_Check(void)
+{
+    SIM_Set_Pin(benchSyringe.fault_pin, HIGH); // Healthy driver
+    BenchSyringeDriver::Init(&benchSyringe);
+    MOTION_Register_Axis(MOTION_AXIS_SYRINGE, &benchSyringe);
+    pinMode(BENCH_SYRINGE_BACK_BUMPER_PIN, INPUT_PULLDOWN);
+    attachInterrupt(digitalPinToInterrupt(BENCH_SYRINGE_BACK_BUMPER_PIN), BENCH_Syringe_Back_Limit, RISING);
+    int32_t plantStart = SIM_AXIS_Position(simSyringeAxis);
+
+    MOTION_COMMAND_t cmd = {
+        .type = MOTION_MOVE_STEPS,
+        .steps = 4001, // Odd 1/16 count: ends half way between 1/8 states
+        .direction = DRV8825_FORWARD,
+        .step_mode = DRV8825_SIXTEENTH_STEP,
+        .profile = &benchFineProfile,
+        .limit_pin = -1,
+        .on_complete = NULL,
+        .context = NULL,
+        .coarse_profile = NULL,
+        .approach_steps = 0};
+    int failures = BENCH_Phase_Move("fine forward", &cmd, plantStart, MOTION_RESULT_DONE, 4001);
+
+    cmd.steps = 3001;
+    cmd.coarse_profile = &benchCoarseProfile;
+    cmd.approach_steps = 160;
+    failures += BENCH_Phase_Move("adaptive forward", &cmd, plantStart, MOTION_RESULT_DONE, 3001);
+
+    cmd.steps = 1001;
+    cmd.direction = DRV8825_BACKWARD;
+    failures += BENCH_Phase_Move("adaptive backward", &cmd, plantStart, MOTION_RESULT_DONE, 1001);
+
+    // Retract to the bumper at 1/4 step from a 1/16 phase: lead-in at 1/32
+    int32_t quarters = (MOTION_Get_Position(MOTION_AXIS_SYRINGE) + plantStart) / MOTION_Step_Size(DRV8825_QUARTER_STEP);
+    cmd.type = MOTION_MOVE_UNTIL_LIMIT;
+    cmd.steps = quarters + 500;
+    cmd.step_mode = DRV8825_QUARTER_STEP;
+    cmd.limit_pin = BENCH_SYRINGE_BACK_BUMPER_PIN;
+    cmd.approach_steps = 500 + 400; // Margin + 100 full steps
+    failures += BENCH_Phase_Move("adaptive retract", &cmd, plantStart, MOTION_RESULT_LIMIT, 0);
+
+    DRV8825_Disable(&benchSyringe);
+    return failures;
+}
+#endif
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(2000); // Allow USB Serial to connect
+
+#if !defined(ARDUINO_ARCH_ESP32)
+    SIM_Set_Pin(benchMotor.fault_pin, HIGH); // Healthy driver
+#endif
+    BenchDriver::Init(&benchMotor);
+    pinMode(BENCH_FRONT_BUMPER_PIN, INPUT_PULLDOWN);
+    pinMode(BENCH_BACK_BUMPER_PIN, INPUT_PULLDOWN);
+    attachInterrupt(digitalPinToInterrupt(BENCH_FRONT_BUMPER_PIN), BENCH_Front_Limit, RISING);
+    attachInterrupt(digitalPinToInterrupt(BENCH_BACK_BUMPER_PIN), BENCH_Back_Limit, RISING);
+
+    Serial.printf("[BENCH] DRV8825 step engine, %d steps per point, CPU %lu MHz\n",
+                  DRV8825_BENCH_SAMPLES, (unsigned long)getCpuFrequencyMhz());
+    Serial.println("load  mode  delay  steps lost target/s  actual/s   p50 ns   p99 ns p99.9 ns   max ns latency ns");
+
+    int failures = BENCH_Sweep(BENCH_LOAD_QUIET);
+    failures += BENCH_Sweep(BENCH_LOAD_RADIO);
+    DRV8825_Disable(&benchMotor);
+#if !defined(ARDUINO_ARCH_ESP32)
+    failures += BENCH_Phase_Check();
+#endif
+
+    Serial.printf("[BENCH] Done, %d failed point(s)\n", failures);
+#if !defined(ARDUINO_ARCH_ESP32)
+    SIM_Finish(failures ? 1 : 0);
+#endif
+}
+
+void loop()
+{
+    delay(1000);
+}
+
+#endif // DRV8825_BENCH
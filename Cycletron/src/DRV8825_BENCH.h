@@ -0,0 +1,46 @@
+/**
+ * @file    DRV8825_BENCH.h
+ * @brief   Step pulse timestamping for the DRV8825 benchmark build
+ *
+ * Only used when DRV8825_BENCH is defined (see the `bench` and
+ * `native_bench` environments). The step timer ISR then records the CPU
+ * cycle counter on every rising STEP edge, and DRV8825_BENCH.cpp turns the
+ * stamps into step rate, jitter and latency figures.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef DRV8825_BENCH_H
+#define DRV8825_BENCH_H
+
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include "hal/cpu_hal.h"
+#define DRV8825_BENCH_CYCLES() cpu_hal_get_cycle_count()
+#else
+#include "SIM_HAL.h"
+#define DRV8825_BENCH_CYCLES() SIM_Cycle_Count()
+#endif
+
+// === Benchmark Sizes ===
+#define DRV8825_BENCH_SAMPLES 2048  // Steps timed per sweep point
+
+extern volatile uint32_t benchStamps[DRV8825_BENCH_SAMPLES];
+extern volatile uint32_t benchStampCount;
+
+/**
+ * @brief Records the cycle counter for one step (called from the step ISR).
+ *
+ * Stamps past DRV8825_BENCH_SAMPLES are dropped. A couple of cycles per
+ * step, so it barely affects what it measures.
+ */
+static inline void IRAM_ATTR DRV8825_BENCH_Stamp(void) {
+  uint32_t n = benchStampCount;
+  if (n < DRV8825_BENCH_SAMPLES) {
+    benchStamps[n] = DRV8825_BENCH_CYCLES();
+    benchStampCount = n + 1;
+  }
+}
+
+#endif // DRV8825_BENCH_H
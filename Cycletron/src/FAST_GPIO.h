@@ -0,0 +1,131 @@
+/**
+ * @file    FAST_GPIO.h
+ * @brief   Direct register GPIO writes for the ESP32-S3
+ *
+ * digitalWrite() goes through the pin lookup and a read-modify-write of the
+ * output register on every call. These helpers write the write-1-to-set /
+ * write-1-to-clear registers directly instead, so one store changes any
+ * number of pins in a bank at the same instant and never disturbs the
+ * others. Everything is inline and IRAM safe for use in the step ISR.
+ *
+ * Pins must already be configured as OUTPUT with pinMode().
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef FAST_GPIO_H
+#define FAST_GPIO_H
+
+#include <Arduino.h>
+#if defined(ARDUINO_ARCH_ESP32)
+#include "soc/gpio_struct.h"
+#endif
+
+/**
+ * @struct FAST_GPIO_MASK_t
+ * @brief  Set of output pins, one bit per GPIO.
+ */
+typedef struct
+{
+    uint32_t low;  ///< GPIO 0-31 (out_w1ts / out_w1tc)
+    uint32_t high; ///< GPIO 32-48, bit n = GPIO 32+n (out1_w1ts / out1_w1tc)
+} FAST_GPIO_MASK_t;
+
+/**
+ * @brief Adds a pin to a mask. Negative pins (unused) are ignored.
+ */
+static inline void FAST_GPIO_Add(FAST_GPIO_MASK_t *mask, int pin)
+{
+    if (pin < 0)
+        return;
+    if (pin < 32)
+        mask->low |= 1UL << pin;
+    else
+        mask->high |= 1UL << (pin - 32);
+}
+
+/**
+ * @brief Returns a mask holding a single pin.
+ */
+static inline FAST_GPIO_MASK_t FAST_GPIO_Mask(int pin)
+{
+    FAST_GPIO_MASK_t mask = {0, 0};
+    FAST_GPIO_Add(&mask, pin);
+    return mask;
+}
+
+#if !defined(ARDUINO_ARCH_ESP32)
+/**
+ * @brief Portable fallback for non-ESP32 builds: one digitalWrite per pin.
+ */
+static inline void FAST_GPIO_Write_Pins(const FAST_GPIO_MASK_t *mask, int level)
+{
+    for (int pin = 0; pin < 64; pin++)
+    {
+        uint32_t bank = (pin < 32) ? mask->low : mask->high;
+        if (bank & (1UL << (pin & 31)))
+            digitalWrite(pin, level);
+    }
+}
+#endif
+
+/**
+ * @brief Drives every pin in the mask HIGH.
+ */
+static inline void IRAM_ATTR FAST_GPIO_Set(const FAST_GPIO_MASK_t *mask)
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    if (mask->low)
+        GPIO.out_w1ts = mask->low;
+    if (mask->high)
+        GPIO.out1_w1ts.val = mask->high;
+#else
+    FAST_GPIO_Write_Pins(mask, HIGH);
+#endif
+}
+
+/**
+ * @brief Drives every pin in the mask LOW.
+ */
+static inline void IRAM_ATTR FAST_GPIO_Clear(const FAST_GPIO_MASK_t *mask)
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    if (mask->low)
+        GPIO.out_w1tc = mask->low;
+    if (mask->high)
+        GPIO.out1_w1tc.val = mask->high;
+#else
+    FAST_GPIO_Write_Pins(mask, LOW);
+#endif
+}
+
+/**
+ * @brief Drives `high` pins HIGH, then `low` pins LOW.
+ *
+ * Two stores per bank (set, then clear), so this is not atomic: between
+ * them the pins already set are HIGH while the ones to clear have not
+ * dropped yet. A single masked store to GPIO.out would need a
+ * read-modify-write, and a critical section does not stop the other
+ * core: a STEP pulse it sets or clears between the read and the write
+ * would be undone. Only use it where the mixed state is never sampled,
+ * as with the MODE pins of a driver at rest.
+ */
+static inline void IRAM_ATTR FAST_GPIO_Write(const FAST_GPIO_MASK_t *high, const FAST_GPIO_MASK_t *low)
+{
+    FAST_GPIO_Set(high);
+    FAST_GPIO_Clear(low);
+}
+
+/**
+ * @brief Single-pin digitalWrite() replacement.
+ */
+static inline void IRAM_ATTR FAST_GPIO_Write_Pin(int pin, int level)
+{
+    FAST_GPIO_MASK_t mask = FAST_GPIO_Mask(pin);
+    if (level)
+        FAST_GPIO_Set(&mask);
+    else
+        FAST_GPIO_Clear(&mask);
+}
+
+#endif // FAST_GPIO_H
@@ -0,0 +1,137 @@
+/**
+ * @file    FSM.cpp
+ * @brief   Table-driven system state machine, woken by events
+ *
+ * Date:   Oct 2026
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include "FSM.h"
+#include "send_functions.h"
+
+static const FSM_STATE_t *states = NULL;
+static FSM_HANDLER_t handlers[FSM_EVENT_COUNT];
+static FSM_OBSERVER_t observer = NULL;
+
+static QueueHandle_t events = NULL;
+static std::atomic<bool> pending[FSM_EVENT_COUNT]; // Kind already queued
+static uint32_t transitions = 0;
+
+static bool tickDue = true;           // Run the tick without waiting (new state, first run)
+static unsigned long nextTick = 0;    // millis() the current state asked for
+
+bool FSM_Init(const FSM_STATE_t *table)
+{
+    for (int i = 0; i < FSM_STATE_COUNT; i++)
+    {
+        if ((int)table[i].state != i)
+        {
+            Serial.printf("[FSM] State table row %d is out of order\n", i);
+            return false;
+        }
+    }
+    states = table;
+    if (events == NULL)
+        events = xQueueCreate(FSM_EVENT_COUNT, sizeof(FSM_EVENT_t));
+    tickDue = true;
+    return true;
+}
+
+void FSM_Set_Handler(FSM_EVENT_t event, FSM_HANDLER_t handler)
+{
+    handlers[event] = handler;
+}
+
+void FSM_Set_Observer(FSM_OBSERVER_t newObserver)
+{
+    observer = newObserver;
+}
+
+bool FSM_Post(FSM_EVENT_t event)
+{
+    if (events == NULL)
+        return false;
+    if (pending[event].exchange(true))
+        return true; // Still queued; its handler will see this one too
+
+    // One slot per kind, so this cannot fail
+    xQueueSend(events, &event, 0);
+    return true;
+}
+
+void FSM_Run(void)
+{
+    TickType_t wait = 0;
+    if (!tickDue)
+    {
+        long left = (long)(nextTick - millis());
+        wait = (left > 0) ? pdMS_TO_TICKS(left) : 0;
+    }
+
+    FSM_EVENT_t event;
+    if (events != NULL && xQueueReceive(events, &event, wait) == pdTRUE)
+    {
+        pending[event].store(false); // Clear first: anything newer queues again
+        if (handlers[event])
+            handlers[event]();
+    }
+    else if (events == NULL && wait > 0)
+    {
+        delay(wait * portTICK_PERIOD_MS); // No event sources before FSM_Init()
+    }
+
+    if (states == NULL || states[(int)currentState].tick == NULL)
+    {
+        tickDue = false;
+        nextTick = millis() + FSM_MAX_WAIT_MS;
+        return;
+    }
+
+    tickDue = false; // A transition in the tick sets it again
+    unsigned long now = millis();
+    uint32_t next = states[(int)currentState].tick(now);
+    if (next > FSM_MAX_WAIT_MS)
+        next = FSM_MAX_WAIT_MS;
+    nextTick = now + next;
+}
+
+void setState(SystemState newState)
+{
+    SystemState from = currentState;
+    const FSM_STATE_t *oldRow = states ? &states[(int)from] : NULL;
+    const FSM_STATE_t *newRow = states ? &states[(int)newState] : NULL;
+
+    if (oldRow && oldRow->exit)
+        oldRow->exit(newState);
+
+    // While the run is held, previousState keeps the state to resume
+    if (!FSM_Holds_Run(from))
+        previousState = from;
+    currentState = newState;
+    transitions++;
+    tickDue = true;
+
+    if (newRow && newRow->entry)
+        newRow->entry(from);
+
+    Serial.printf("[FSM] %s -> %s\n", FSM_State_Name(from), FSM_State_Name(newState));
+    sendCurrentState();
+    if (observer)
+        observer(from, newState);
+}
+
+bool FSM_Holds_Run(SystemState state)
+{
+    return states != NULL && states[(int)state].holdsRun;
+}
+
+const char *FSM_State_Name(SystemState state)
+{
+    return states ? states[(int)state].name : "UNKNOWN";
+}
+
+uint32_t FSM_Transitions(void)
+{
+    return transitions;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file    FSM.h
+ * @brief   Table-driven system state machine, woken by events
+ *
+ * Each SystemState has a row with entry, exit and tick handlers (main.cpp
+ * owns the table). Every transition goes through setState(): it runs the
+ * old state's exit, updates the resume state, runs the new state's entry,
+ * reports the new state to the server and calls the observer, so there is
+ * one place to audit or instrument.
+ *
+ * The control task (loop()) sleeps in FSM_Run() until something happens:
+ *
+ *   FSM_EVENT_FRAME   the comms task received a frame (COMMS.h)
+ *   FSM_EVENT_MOTION  the motion task finished a move (MOTION.h)
+ *   timer             the current state's tick asked to run again
+ *
+ * Events only say where to look: each kind is queued at most once until
+ * its handler runs, and the handler drains its source (the comms inbox,
+ * the motion completion queue). The queue therefore never overflows and a
+ * burst of frames costs one wake-up.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef FSM_H
+#define FSM_H
+
+#include <Arduino.h>
+#include "globals.h"
+
+#define FSM_STATE_COUNT ((int)SystemState::ERROR + 1)
+#define FSM_MAX_WAIT_MS 1000  // Longest sleep between ticks, whatever a state asks for
+
+/**
+ * @brief Events that wake the control task.
+ */
+typedef enum
+{
+    FSM_EVENT_FRAME = 0, ///< Frames waiting in the comms inbox
+    FSM_EVENT_MOTION,    ///< Finished moves waiting for MOTION_Service()
+    FSM_EVENT_COUNT
+} FSM_EVENT_t;
+
+/**
+ * @brief Runs when the state is entered.
+ *
+ * @param from State being left
+ */
+typedef void (*FSM_ENTRY_t)(SystemState from);
+
+/**
+ * @brief Runs when the state is left, before the next state's entry.
+ *
+ * @param to State being entered
+ */
+typedef void (*FSM_EXIT_t)(SystemState to);
+
+/**
+ * @brief Periodic work of the state; runs after every event and timer.
+ *
+ * @param now millis() at the start of the tick
+ * @return Milliseconds until it should run again without an event
+ *         (capped at FSM_MAX_WAIT_MS)
+ */
+typedef uint32_t (*FSM_TICK_t)(unsigned long now);
+
+/**
+ * @brief Drains the source of one event kind, in the control task.
+ */
+typedef void (*FSM_HANDLER_t)(void);
+
+/**
+ * @brief Observer of every transition, called after the new state's entry.
+ */
+typedef void (*FSM_OBSERVER_t)(SystemState from, SystemState to);
+
+/**
+ * @struct FSM_STATE_t
+ * @brief  One row of the state table.
+ *
+ * Rows are indexed by SystemState and must list it in `state`.
+ * Any handler may be NULL.
+ */
+typedef struct
+{
+    SystemState state; ///< State of this row
+    const char *name;  ///< For logs
+    bool holdsRun;     ///< Interrupts the run; leaving it resumes previousState
+    FSM_ENTRY_t entry;
+    FSM_EXIT_t exit;
+    FSM_TICK_t tick;
+} FSM_STATE_t;
+
+/**
+ * @brief Installs the state table and creates the event queue.
+ *
+ * Call early in setup(), before the event sources start. The current
+ * state's entry is not run; its first tick is.
+ *
+ * @param table FSM_STATE_COUNT rows, kept by reference
+ * @return false if a row is out of order
+ */
+bool FSM_Init(const FSM_STATE_t *table);
+
+/**
+ * @brief Sets the function that drains the source of an event kind.
+ */
+void FSM_Set_Handler(FSM_EVENT_t event, FSM_HANDLER_t handler);
+
+/**
+ * @brief Sets the transition observer, NULL for none.
+ */
+void FSM_Set_Observer(FSM_OBSERVER_t observer);
+
+/**
+ * @brief Wakes the control task; any task, never blocks.
+ *
+ * @param event What happened
+ * @return false if the event queue does not exist yet
+ */
+bool FSM_Post(FSM_EVENT_t event);
+
+/**
+ * @brief Waits for the next event or the state's timer, handles it and
+ *        runs the current state's tick. Call from loop().
+ */
+void FSM_Run(void);
+
+/**
+ * @brief Changes the system state; control task only.
+ *
+ * The only way the state changes: runs the exit and entry handlers,
+ * keeps previousState as the state to resume unless the run is already
+ * held, and sends the new state to the server. Also works before
+ * FSM_Init(), without handlers.
+ *
+ * @param newState The state to transition to
+ */
+void setState(SystemState newState);
+
+/**
+ * @brief True if the state interrupts the run (PAUSED, EXTRACTING, REFILLING).
+ */
+bool FSM_Holds_Run(SystemState state);
+
+/**
+ * @brief Name of a state from the table, "UNKNOWN" before FSM_Init().
+ */
+const char *FSM_State_Name(SystemState state);
+
+/**
+ * @brief Transitions made since boot.
+ */
+uint32_t FSM_Transitions(void);
+
+#endif // FSM_H
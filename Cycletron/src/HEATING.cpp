@@ -3,91 +3,227 @@
  * @brief   Heating control module for thermistor-based pad using ESP32
  *
  * Measures temperature using a thermistor voltage divider and applies
- * bang-bang control to a heating pad via GPIO. Uses a moving average
- * filter for both ADC and temperature readings to smooth out noise.
+ * PID or bang-bang control to a heating pad via GPIO. The divider is sampled
+ * in the background at a fixed rate (HEATING_ADC.h), and every sample
+ * updates a Kalman estimate of temperature and its rate of change
+ * (HEATING_ESTIMATOR.h). Control and telemetry read the estimate, which
+ * follows ramps without the lag of averaging; the bang-bang law also uses
+ * the rate to switch off before the sensor lag makes it overshoot.
+ *
+ * Control runs in its own FreeRTOS task at a fixed HEATING_TASK_PERIOD_MS,
+ * pinned to one core above loop()'s priority, so regulation does not
+ * depend on how long the state machine or a motor move keeps loop() busy.
+ * The rest of the firmware only commands it: a setpoint (HEATING_Set_Temp()),
+ * off (HEATING_Off()), mode, gains and autotune. A mutex keeps those
+ * commands from landing in the middle of a control step.
+ *
+ * Every control law sets a heater power of 0-100% (HEATING_Set_Power()),
+ * delivered independently of loop() timing: by LEDC hardware PWM, or for
+ * SSR/relay drive by a slow time-proportional window switched from a
+ * hardware timer (see HEATING_DRIVE in HEATING.h).
+ *
+ * The PID recomputes the power every sample_ms. The integral is clamped to the output
+ * range and frozen while the output is saturated in the direction the error
+ * pushes (anti-windup), and the derivative acts on the measurement so
+ * setpoint changes do not kick the output.
  *
  * Author: Rafael Delwart
  * Date:   20 Feb 2025 (ESP32 update: May 2025)
  */
 
  #include <Arduino.h>
+ #include <Preferences.h>
+ #include "FAST_GPIO.h"
  #include "HEATING.h"
+ #include "HEATING_ADC.h"
+ #include "HEATING_ESTIMATOR.h"
+ #include "THERMISTOR.h"
 
  #include <math.h>
  
  #define Serial0 Serial
  
  // === CONFIG ===
- #define THERMISTOR_PIN 4        // ADC1_CHANNEL_0 = GPIO4 (ESP32-S3)
- #define MOVING_AVERAGE_WINDOW 80 // Size of moving average window
- #define VREF 3.28                // ADC reference voltage
- #define ADC_RESOLUTION 4095.0   // 12-bit ADC = 4096 levels
+ #define THERMISTOR_PIN 4        // ADC1_CHANNEL_3 = GPIO4 (ESP32-S3)
 
  #define roomTempCalibrationOffset 18 // Calibration offset for room temperature
 
 //  #define TESTING_TEMP
 
- // === Thermistor constants ===
- const float R0   = 100000.0;     // Resistance at 25°C (reference temp)
- const float R1   = 4630.0;       // Fixed series resistor in voltage divider
- const float BETA = 3850.0;       // Beta value of thermistor
- const float T0   = 298.15;       // Reference temp in Kelvin (25°C)
- 
- // === Buffers for Moving Average ===
- static float   mvBuffer[MOVING_AVERAGE_WINDOW] = {0}; // Circular buffer for MV readings
- static int   mvIndex = 0, mvCount = 0;
- 
- static float tempBuffer[MOVING_AVERAGE_WINDOW] = {0}; // Circular buffer for temperature
- static int   tempIndex = 0, tempCount = 0;
+ // === PID Defaults ===
+ // Tuned on the pad model in lib/SimHAL (about 1 °C per % at steady state,
+ // 10 min time constant, 30 s sensor lag); override per station from the
+ // parameters packet. PID only runs once a station has gains of its own
+ // (autotuned, from NVS) or the packet asks for it; bang-bang otherwise.
+ #define HEATING_PID_KP 25.0f
+ #define HEATING_PID_KI 0.25f
+ #define HEATING_PID_KD 150.0f
+ #define HEATING_PID_SAMPLE_MS 1000
+ #define HEATING_PID_RAMP_RATE 0.0f
+ #define HEATING_OUTPUT_MAX 100.0f
+
+ // === Control Task ===
+ #define HEATING_TASK_PERIOD_MS 50      // 20 Hz
+ #define HEATING_TASK_PRIORITY 10       // Above loop() (1)
+ #define HEATING_TASK_CORE 1            // Radio and the ADC reader run on core 0
+ #define HEATING_TASK_STACK 4096
+
+ // === Bang-Bang ===
+ #define HEATING_BANG_BANG_LEAD_S 20.0f  // Switch on the temperature predicted this far ahead
+
+ // === Heater Drive ===
+ #define HEATING_LEDC_CHANNEL 0
+ #define HEATING_PWM_FREQ_HZ 1000       // MOSFET switching a DC pad
+ #define HEATING_PWM_BITS 10
+ #define HEATING_PWM_MAX ((1 << HEATING_PWM_BITS) - 1)
+
+ #define HEATING_WINDOW_TIMER 3         // DRV8825 channels take the lower timers
+ #define HEATING_WINDOW_MS 1000         // Time-proportional window (SSR / relay)
+ #define HEATING_WINDOW_TICK_MS 10      // Switching resolution, 1% of the window
+ #define HEATING_WINDOW_TICKS (HEATING_WINDOW_MS / HEATING_WINDOW_TICK_MS)
+
+ // === Autotune ===
+ #define HEATING_AUTOTUNE_HYSTERESIS 0.25f         // Relay band around the setpoint (°C)
+ #define HEATING_AUTOTUNE_CYCLES 5                 // Oscillations to run, the first is discarded
+ #define HEATING_AUTOTUNE_TIMEOUT_MS (3UL * 3600UL * 1000UL)
+ #define HEATING_AUTOTUNE_OVERSHOOT_LIMIT 15.0f    // Abort if this far above the setpoint (°C)
+ #define HEATING_AUTOTUNE_MIN_C 30.0f
+ #define HEATING_AUTOTUNE_MAX_C 110.0f
+
+ // === NVS ===
+ #define HEATING_NVS_NAMESPACE "heating"
+
+ // === Controller State (guarded by heatingLock) ===
+ static SemaphoreHandle_t heatingLock = NULL;
+ static bool heatingEnabled = false;    // Regulating to heatingSetpoint, see HEATING_Set_Temp()
+ static float heatingSetpoint = 0;
+ static HEATING_MODE_t heatingMode = HEATING_MODE_BANG_BANG;
+ static HEATING_PID_t heatingPID = {
+   .kp = HEATING_PID_KP,
+   .ki = HEATING_PID_KI,
+   .kd = HEATING_PID_KD,
+   .sample_ms = HEATING_PID_SAMPLE_MS,
+   .ramp_rate = HEATING_PID_RAMP_RATE};
+
+ static bool pidRunning = false;        // False until the first sample after Off/Set_PID
+ static unsigned long pidLastSample = 0; // Start of the current window (ms)
+ static float pidIntegral = 0;          // Integral term, already scaled by ki (%)
+ static float pidSetpoint = 0;          // Ramped setpoint
+ static float heatingOutput = 0;        // Heater power in %, see HEATING_Set_Power()
+
+ // === Estimator (updated from the ADC reader) ===
+ static HEATING_ESTIMATOR_t estimator;
+ static volatile float estimateTemp = 0;
+ static volatile float estimateRate = 0;
+
+ #if HEATING_DRIVE == HEATING_DRIVE_WINDOW
+ static hw_timer_t *windowTimer = NULL;
+ static volatile uint32_t windowOnTicks = 0;  // Ticks per window with the heater on
+ static uint32_t windowTick = 0;
+ static FAST_GPIO_MASK_t heaterMask;
+
+ /**
+  * @brief Window timer: heater on for the first windowOnTicks of every window.
+  */
+ static void IRAM_ATTR HEATING_Window_ISR() {
+   if (windowTick < windowOnTicks) FAST_GPIO_Set(&heaterMask);
+   else FAST_GPIO_Clear(&heaterMask);
+   if (++windowTick >= HEATING_WINDOW_TICKS) windowTick = 0;
+ }
+ #endif
+
+ // === Autotune State ===
+ static HEATING_AUTOTUNE_t autotune = {
+   .status = HEATING_AUTOTUNE_IDLE,
+   .setpoint = 0,
+   .cycles = 0,
+   .totalCycles = 0,
+   .amplitude = 0,
+   .ku = 0,
+   .tu = 0,
+   .pid = {.kp = 0, .ki = 0, .kd = 0, .sample_ms = 0, .ramp_rate = 0}};
+ static bool autotuneHeating = false;         // Relay output
+ static unsigned long autotuneStart = 0;
+ static unsigned long autotuneLastRise = 0;   // Relay switched off (upward crossing), 0 = not yet
+ static float autotunePeakHigh = 0;           // Extremes of the current cycle
+ static float autotunePeakLow = 0;
+ static float autotunePeriodSum = 0;          // Over the cycles used (all but the first)
+ static float autotuneAmplitudeSum = 0;
+ static int autotuneUsed = 0;
+
+ static void HEATING_Task(void *parameter);
  
+ /**
+  * @brief ADC hook: one output sample into the estimator.
+  */
+ static void HEATING_On_Sample(float mv) {
+   mv += roomTempCalibrationOffset;
+   if (mv <= 0 || mv >= THERMISTOR_VREF * 1000) return;  // Open or shorted sensor
+
+   HEATING_ESTIMATOR_Update(&estimator, THERMISTOR_MV_To_C(mv), 1.0f / HEATING_ADC_OUTPUT_HZ);
+   estimateTemp = estimator.temp;
+   estimateRate = estimator.rate;
+ }
+
  // === API IMPLEMENTATION ===
  
  /**
   * @brief Initializes GPIO and ADC for heating system.
   *
   * Configures the heater control GPIO as OUTPUT and sets it LOW (off).
-  * Sets ADC resolution to 12-bit. Should be called once at startup.
+  * Starts background sampling of the thermistor and the control task.
+  * Should be called once at startup.
   */
  void HEATING_Init() {
    pinMode(HEATING_GPIO, OUTPUT);
    digitalWrite(HEATING_GPIO, LOW);  // Off by default
-   analogReadResolution(12);         // 12-bit for ESP32
-   analogSetAttenuation(ADC_11db);      // Set full voltage range 0–3.3V
+ #if HEATING_DRIVE == HEATING_DRIVE_LEDC
+   ledcSetup(HEATING_LEDC_CHANNEL, HEATING_PWM_FREQ_HZ, HEATING_PWM_BITS);
+   ledcAttachPin(HEATING_GPIO, HEATING_LEDC_CHANNEL);
+   ledcWrite(HEATING_LEDC_CHANNEL, 0);
+ #else
+   heaterMask = FAST_GPIO_Mask(HEATING_GPIO);
+   windowTimer = timerBegin(HEATING_WINDOW_TIMER, 80, true);  // 1 tick per us
+   timerAttachInterrupt(windowTimer, HEATING_Window_ISR, true);
+   timerAlarmWrite(windowTimer, HEATING_WINDOW_TICK_MS * 1000ULL, true);
+   timerAlarmEnable(windowTimer);
+ #endif
+   HEATING_ESTIMATOR_Init(&estimator, HEATING_ESTIMATOR_ACCEL_NOISE, HEATING_ESTIMATOR_MEAS_NOISE);
+   HEATING_ADC_Set_Hook(HEATING_On_Sample);
+   if (!HEATING_ADC_Init(THERMISTOR_PIN)) {
+     Serial.println("[HEATING] Thermistor ADC failed to start");
+   }
+   if (HEATING_Load_PID()) {
+     heatingMode = HEATING_MODE_PID;  // This station has been tuned
+     Serial.printf("[HEATING] PID gains from NVS: Kp %.3f Ki %.4f Kd %.2f\n", heatingPID.kp, heatingPID.ki, heatingPID.kd);
+   }
+   heatingLock = xSemaphoreCreateMutex();
+   xTaskCreatePinnedToCore(HEATING_Task, "heating", HEATING_TASK_STACK, NULL,
+                           HEATING_TASK_PRIORITY, NULL, HEATING_TASK_CORE);
    Serial.println("[HEATING] Initialized GPIO and ADC");
  }
  
  /**
-  * @brief Reads a raw MilliVolt value from the thermistor pin.
+  * @brief Latest thermistor divider sample in MilliVolts.
   *
-  * This is a direct analog read of the thermistor divider output.
+  * One oversampled block from the background ADC; never waits.
   *
-  * @return ADC value from 0 to 4095
+  * @return Divider output in mV
   */
  int HEATING_Measure_Raw_MV() {
-  return analogReadMilliVolts(THERMISTOR_PIN) + roomTempCalibrationOffset;
+  return (int)lroundf(HEATING_ADC_Latest_MV()) + roomTempCalibrationOffset;
 }
  
  /**
-  * @brief Computes the moving average of recent MilliVolt readings.
+  * @brief Moving average of the divider output.
   *
-  * Stores readings in a circular buffer and returns the average.
-  * Helps reduce noise in thermistor signal.
+  * Maintained by the background ADC over uniformly spaced samples; this
+  * only reads the latest result.
   *
-  * @return Averaged ADC reading
+  * @return Averaged divider output in Volts
   */
  float HEATING_Measure_AVG_MV() {
-  float newMV = HEATING_Measure_Raw_MV() / 1000.0; // Convert to Volts
-  mvBuffer[mvIndex] = newMV;
-  mvIndex = (mvIndex + 1) % MOVING_AVERAGE_WINDOW;
-  if (mvCount < MOVING_AVERAGE_WINDOW) mvCount++;
-
-  float sum = 0;
-  for (int i = 0; i < mvCount; i++) {
-      sum += mvBuffer[i];
-  }
-
-  float avg = sum / mvCount;
-  return avg;
+ return (HEATING_ADC_Average_MV() + roomTempCalibrationOffset) / 1000.0; // Convert to Volts
 }
  
 
@@ -101,65 +237,372 @@
  float HEATING_Measure_Resistance() {
    float Vout = HEATING_Measure_AVG_MV();
    if (Vout <= 0) return -1.0;
-   return R1 * (VREF - Vout) / Vout;
+   return THERMISTOR_MV_To_Ohms(Vout * 1000.0);
  }
  
  /**
-  * @brief Converts thermistor resistance to temperature using BETA formula.
+  * @brief Converts the divider output to temperature.
   *
-  * Applies the Steinhart-Hart simplified BETA equation to compute temperature.
+  * Looks the averaged voltage up in the compile-time table (THERMISTOR.h,
+  * BETA or Steinhart-Hart), so no division or log() per reading.
   *
   * @return Temperature in degrees Celsius
   */
  float HEATING_Measure_Temp() {
-   float R = HEATING_Measure_Resistance();
-   if (R <= 0) return -273.15;  // Absolute zero on error
-   float tempK = 1.0 / ((1.0 / T0) + (1.0 / BETA) * log(R / R0));
-   return tempK - 273.15;
+   float mv = HEATING_ADC_Average_MV() + roomTempCalibrationOffset;
+   if (mv <= 0 || mv >= THERMISTOR_VREF * 1000) return -273.15;  // Absolute zero on error
+   return THERMISTOR_MV_To_C(mv);
  }
  
  /**
-  * @brief Computes moving average of temperature readings.
+  * @brief Filtered temperature.
   *
-  * Smooths out sensor noise by averaging recent temperature measurements.
+  * The averaging happens on the voltage, at the ADC's fixed rate, so the
+  * result does not depend on how often this is called.
   *
   * @return Averaged temperature in degrees Celsius
   */
  float HEATING_Measure_Temp_Avg() {
-   float newTemp = HEATING_Measure_Temp();
-   tempBuffer[tempIndex] = newTemp;
-   tempIndex = (tempIndex + 1) % MOVING_AVERAGE_WINDOW;
-   if (tempCount < MOVING_AVERAGE_WINDOW) tempCount++;
- 
-   float sum = 0;
-   for (int i = 0; i < tempCount; i++) sum += tempBuffer[i];
-   return sum / tempCount;
+   return HEATING_Measure_Temp();
+ }
+
+ float HEATING_Estimate_Temp(void) {
+   if (!estimator.primed) return HEATING_Measure_Temp();
+   return estimateTemp;
+ }
+
+ float HEATING_Estimate_Rate(void) {
+   return estimateRate;
  }
  
  /**
-  * @brief Simple bang-bang temperature controller.
+  * @brief One PID step on the estimated temperature.
   *
-  * Turns heater ON if temperature is below setpoint.
-  * Turns heater OFF if temperature is above or equal to setpoint.
+  * @param setpointCelsius Final target
+  * @param temp            Estimated temperature
+  * @param rate            Estimated rate of change (°C/s)
+  * @param dt              Seconds since the previous sample
+  * @return Output in percent
+  */
+ static float HEATING_PID_Step(float setpointCelsius, float temp, float rate, float dt) {
+   // Setpoint ramp
+   if (heatingPID.ramp_rate > 0) {
+     float maxStep = heatingPID.ramp_rate * dt;
+     float delta = setpointCelsius - pidSetpoint;
+     if (delta > maxStep) delta = maxStep;
+     if (delta < -maxStep) delta = -maxStep;
+     pidSetpoint += delta;
+   } else {
+     pidSetpoint = setpointCelsius;
+   }
+
+   float error = pidSetpoint - temp;
+   float derivative = -rate;  // On measurement
+
+   float unclamped = heatingPID.kp * error + pidIntegral + heatingPID.ki * error * dt + heatingPID.kd * derivative;
+
+   // Anti-windup: integrate only if that does not push a saturated output further
+   bool saturatedHigh = unclamped > HEATING_OUTPUT_MAX && error > 0;
+   bool saturatedLow = unclamped < 0 && error < 0;
+   if (!saturatedHigh && !saturatedLow) {
+     pidIntegral += heatingPID.ki * error * dt;
+   }
+   pidIntegral = constrain(pidIntegral, 0.0f, HEATING_OUTPUT_MAX);
+
+   float output = heatingPID.kp * error + pidIntegral + heatingPID.kd * derivative;
+   return constrain(output, 0.0f, HEATING_OUTPUT_MAX);
+ }
+
+ /**
+  * @brief Sets the heater power.
+  *
+  * @param percent 0-100, clamped
+  */
+ void HEATING_Set_Power(float percent) {
+   heatingOutput = constrain(percent, 0.0f, HEATING_OUTPUT_MAX);
+ #if HEATING_DRIVE == HEATING_DRIVE_LEDC
+   ledcWrite(HEATING_LEDC_CHANNEL, (uint32_t)lroundf(heatingOutput * HEATING_PWM_MAX / HEATING_OUTPUT_MAX));
+ #else
+   windowOnTicks = (uint32_t)lroundf(heatingOutput * HEATING_WINDOW_TICKS / HEATING_OUTPUT_MAX);
+ #endif
+ }
+
+ /**
+  * @brief One step of the temperature controller (PID or bang-bang, see
+  *        HEATING_Set_Mode()); control task, lock held.
   *
   * @param setpointCelsius Target temperature in Celsius
   */
- void HEATING_Set_Temp(int setpointCelsius) {
-   float avgTemp = HEATING_Measure_Temp_Avg();
-   if (avgTemp < setpointCelsius) {
-     digitalWrite(HEATING_GPIO, HIGH);  // Turn ON
-   } else {
-     digitalWrite(HEATING_GPIO, LOW);   // Turn OFF
+ static void HEATING_Control_Step(float setpointCelsius) {
+   float temp = HEATING_Estimate_Temp();
+   float rate = HEATING_Estimate_Rate();
+
+   if (heatingMode == HEATING_MODE_BANG_BANG) {
+     float predicted = temp + rate * HEATING_BANG_BANG_LEAD_S;
+     HEATING_Set_Power((predicted < setpointCelsius) ? HEATING_OUTPUT_MAX : 0);
+     return;
+   }
+
+   unsigned long now = millis();
+   if (!pidRunning) {
+     pidRunning = true;
+     pidIntegral = 0;
+     pidSetpoint = (heatingPID.ramp_rate > 0) ? temp : setpointCelsius;
+     pidLastSample = now;
+     HEATING_Set_Power(HEATING_PID_Step(setpointCelsius, temp, rate, 0));
+   } else if (now - pidLastSample >= heatingPID.sample_ms) {
+     float dt = (now - pidLastSample) / 1000.0f;
+     pidLastSample = now;
+     HEATING_Set_Power(HEATING_PID_Step(setpointCelsius, temp, rate, dt));
    }
  }
+
+ /**
+  * @brief Stops regulating and turns the heater off; lock held.
+  */
+ static void HEATING_Stop(void) {
+   heatingEnabled = false;
+   HEATING_Set_Power(0);   // Turn OFF
+   pidRunning = false;
+ }
+
+ /**
+  * @brief Commands the control task to regulate to a setpoint.
+  *
+  * @param setpointCelsius Target temperature in Celsius
+  */
+ void HEATING_Set_Temp(int setpointCelsius) {
+   xSemaphoreTake(heatingLock, portMAX_DELAY);
+   heatingSetpoint = setpointCelsius;
+   heatingEnabled = true;
+   xSemaphoreGive(heatingLock);
+ }
  
  /**
   * @brief Turns off temperature controller.
   *
   */
  void HEATING_Off() {
-    digitalWrite(HEATING_GPIO, LOW);   // Turn OFF
-}
+   xSemaphoreTake(heatingLock, portMAX_DELAY);
+   HEATING_Stop();
+   xSemaphoreGive(heatingLock);
+ }
+
+ void HEATING_Set_Mode(HEATING_MODE_t mode) {
+   xSemaphoreTake(heatingLock, portMAX_DELAY);
+   heatingMode = mode;
+   pidRunning = false;
+   xSemaphoreGive(heatingLock);
+ }
+
+ HEATING_MODE_t HEATING_Get_Mode(void) {
+   return heatingMode;
+ }
+
+ /**
+  * @brief Replaces the gains; lock held.
+  */
+ static void HEATING_Apply_PID(const HEATING_PID_t *pid) {
+   heatingPID = *pid;
+   if (heatingPID.sample_ms == 0) heatingPID.sample_ms = HEATING_PID_SAMPLE_MS;
+   pidRunning = false;
+ }
+
+ void HEATING_Set_PID(const HEATING_PID_t *pid) {
+   xSemaphoreTake(heatingLock, portMAX_DELAY);
+   HEATING_Apply_PID(pid);
+   xSemaphoreGive(heatingLock);
+ }
+
+ const HEATING_PID_t *HEATING_Get_PID(void) {
+   return &heatingPID;
+ }
+
+ float HEATING_Get_Output(void) {
+   return heatingOutput;
+ }
+
+ /**
+  * @brief Computes the PID gains from the ultimate gain and period.
+  *
+  * Uses the Tyreus–Luyben rule (Kp = Ku/2.2, Ti = 2.2·Tu, Td = Tu/6.3): far
+  * less overshoot than Ziegler–Nichols on a slow pad whose sensor lags.
+  */
+ static void HEATING_Autotune_Finish(void) {
+   autotune.tu = autotunePeriodSum / autotuneUsed;
+   autotune.amplitude = autotuneAmplitudeSum / autotuneUsed;
+
+   // Relay swings HEATING_OUTPUT_MAX..0, so d is half of it; correct for the hysteresis band
+   float d = HEATING_OUTPUT_MAX / 2.0f;
+   float a = autotune.amplitude;
+   float h = HEATING_AUTOTUNE_HYSTERESIS;
+   float effective = (a > h) ? sqrtf(a * a - h * h) : a;
+   autotune.ku = 4.0f * d / ((float)M_PI * effective);
+
+   float kp = autotune.ku / 2.2f;
+   float ti = autotune.tu * 2.2f;
+   float td = autotune.tu / 6.3f;
+   autotune.pid = heatingPID;
+   autotune.pid.kp = kp;
+   autotune.pid.ki = kp / ti;
+   autotune.pid.kd = kp * td;
+
+   HEATING_Apply_PID(&autotune.pid);
+   heatingMode = HEATING_MODE_PID;
+   autotune.status = HEATING_AUTOTUNE_DONE;
+   Serial.printf("[HEATING] Autotune done: Ku %.2f Tu %.1f s -> Kp %.3f Ki %.4f Kd %.2f\n",
+                 autotune.ku, autotune.tu, autotune.pid.kp, autotune.pid.ki, autotune.pid.kd);
+ }
+
+ /**
+  * @brief Stops the relay with a failure status.
+  */
+ static void HEATING_Autotune_Fail(const char *reason) {
+   HEATING_Set_Power(0);
+   autotune.status = HEATING_AUTOTUNE_FAILED;
+   Serial.printf("[HEATING] Autotune failed: %s\n", reason);
+ }
+
+ bool HEATING_Autotune_Start(float setpointCelsius) {
+   if (setpointCelsius < HEATING_AUTOTUNE_MIN_C || setpointCelsius > HEATING_AUTOTUNE_MAX_C) {
+     return false;
+   }
+
+   xSemaphoreTake(heatingLock, portMAX_DELAY);
+   autotune.status = HEATING_AUTOTUNE_RUNNING;
+   autotune.setpoint = setpointCelsius;
+   autotune.cycles = 0;
+   autotune.totalCycles = HEATING_AUTOTUNE_CYCLES;
+   autotune.amplitude = autotune.ku = autotune.tu = 0;
+   autotune.pid = heatingPID;
+
+   autotuneHeating = true;
+   autotuneStart = millis();
+   autotuneLastRise = 0;
+   autotunePeakHigh = autotunePeakLow = HEATING_Estimate_Temp();
+   autotunePeriodSum = autotuneAmplitudeSum = 0;
+   autotuneUsed = 0;
+   pidRunning = false;
+   HEATING_Set_Power(HEATING_OUTPUT_MAX);
+   xSemaphoreGive(heatingLock);
+   Serial.printf("[HEATING] Autotune started at %.1f C\n", setpointCelsius);
+   return true;
+ }
+
+ /**
+  * @brief One relay step and oscillation analysis; control task, lock held.
+  */
+ static void HEATING_Autotune_Step(void) {
+   unsigned long now = millis();
+   float temp = HEATING_Estimate_Temp();
+   if (temp > autotune.setpoint + HEATING_AUTOTUNE_OVERSHOOT_LIMIT) {
+     HEATING_Autotune_Fail("overheated");
+     return;
+   }
+   if (now - autotuneStart > HEATING_AUTOTUNE_TIMEOUT_MS) {
+     HEATING_Autotune_Fail("timed out");
+     return;
+   }
+
+   if (temp > autotunePeakHigh) autotunePeakHigh = temp;
+   if (temp < autotunePeakLow) autotunePeakLow = temp;
+
+   if (autotuneHeating && temp > autotune.setpoint + HEATING_AUTOTUNE_HYSTERESIS) {
+     // Upward crossing: one full cycle since the previous one
+     autotuneHeating = false;
+     if (autotuneLastRise != 0) {
+       autotune.cycles++;
+       if (autotune.cycles > 1) {  // First cycle still carries the warm-up
+         autotunePeriodSum += (now - autotuneLastRise) / 1000.0f;
+         autotuneAmplitudeSum += (autotunePeakHigh - autotunePeakLow) / 2.0f;
+         autotuneUsed++;
+       }
+       autotune.amplitude = (autotunePeakHigh - autotunePeakLow) / 2.0f;
+     }
+     autotuneLastRise = now;
+     autotunePeakHigh = autotunePeakLow = temp;
+   } else if (!autotuneHeating && temp < autotune.setpoint - HEATING_AUTOTUNE_HYSTERESIS) {
+     autotuneHeating = true;
+   }
+
+   HEATING_Set_Power(autotuneHeating ? HEATING_OUTPUT_MAX : 0);
+
+   if (autotune.cycles >= autotune.totalCycles) {
+     HEATING_Set_Power(0);
+     if (autotuneUsed > 0 && autotuneAmplitudeSum > 0) {
+       HEATING_Autotune_Finish();
+     } else {
+       HEATING_Autotune_Fail("no oscillation");
+     }
+   }
+ }
+
+ HEATING_AUTOTUNE_STATUS_t HEATING_Autotune_Status(void) {
+   return autotune.status;
+ }
+
+ void HEATING_Autotune_Cancel(void) {
+   xSemaphoreTake(heatingLock, portMAX_DELAY);
+   if (autotune.status == HEATING_AUTOTUNE_RUNNING) {
+     autotune.status = HEATING_AUTOTUNE_IDLE;
+   }
+   HEATING_Stop();
+   xSemaphoreGive(heatingLock);
+ }
+
+ /**
+  * @brief Control task: one step every HEATING_TASK_PERIOD_MS.
+  *
+  * A running autotune owns the heater; otherwise the commanded setpoint is
+  * regulated while enabled. HEATING_Off() has already set the power to 0.
+  */
+ static void HEATING_Task(void *parameter) {
+   (void)parameter;
+   TickType_t lastWake = xTaskGetTickCount();
+   for (;;) {
+     vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(HEATING_TASK_PERIOD_MS));
+     xSemaphoreTake(heatingLock, portMAX_DELAY);
+     if (autotune.status == HEATING_AUTOTUNE_RUNNING) {
+       HEATING_Autotune_Step();
+     } else if (heatingEnabled) {
+       HEATING_Control_Step(heatingSetpoint);
+     }
+     xSemaphoreGive(heatingLock);
+   }
+ }
+
+ const HEATING_AUTOTUNE_t *HEATING_Autotune_Get(void) {
+   return &autotune;
+ }
+
+ bool HEATING_Save_PID(void) {
+   xSemaphoreTake(heatingLock, portMAX_DELAY);
+   HEATING_PID_t pid = heatingPID;
+   xSemaphoreGive(heatingLock);
+
+   Preferences prefs;
+   if (!prefs.begin(HEATING_NVS_NAMESPACE, false)) return false;
+   bool ok = prefs.putFloat("kp", pid.kp) > 0 &&
+             prefs.putFloat("ki", pid.ki) > 0 &&
+             prefs.putFloat("kd", pid.kd) > 0;
+   prefs.end();
+   Serial.printf("[HEATING] %s PID gains to NVS\n", ok ? "Saved" : "Could not save");
+   return ok;
+ }
+
+ bool HEATING_Load_PID(void) {
+   Preferences prefs;
+   if (!prefs.begin(HEATING_NVS_NAMESPACE, true)) return false;
+   bool stored = prefs.isKey("kp") && prefs.isKey("ki") && prefs.isKey("kd");
+   if (stored) {
+     heatingPID.kp = prefs.getFloat("kp", HEATING_PID_KP);
+     heatingPID.ki = prefs.getFloat("ki", HEATING_PID_KI);
+     heatingPID.kd = prefs.getFloat("kd", HEATING_PID_KD);
+     pidRunning = false;
+   }
+   prefs.end();
+   return stored;
+ }
 
 
 
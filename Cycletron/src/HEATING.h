@@ -2,10 +2,11 @@
  * @file    HEATING.h
  * @brief   Silicon Heating Pad control module header for ESP32
  *
- * This module implements simple bang-bang temperature control
+ * This module implements PID (default) or bang-bang temperature control
  * of a heating pad using an NTC thermistor and voltage divider.
- * Raw ADC values are converted to voltage, resistance, and temperature
- * using the BETA model. Moving average filters are applied to smooth noise.
+ * The divider is sampled and filtered in the background; control uses a
+ * Kalman estimate of temperature and its rate of change and runs in its
+ * own fixed-rate task. Callers only command it (setpoint, off, mode, gains).
  *
  * @author  Rafael Delwart
  * @date    20 Feb 2025 (ESP32 update: May 2025)
@@ -18,19 +19,51 @@
 
 
 #define HEATING_GPIO 5         // GPIO to control heater
+#define HEATING_AUTOTUNE_DEFAULT_C 60.0f  // Autotune setpoint when no run target is set
+
+// === Heater Drive ===
+// LEDC: hardware PWM, for a MOSFET switching the pad.
+// WINDOW: 1 s time-proportional window from a timer ISR, for an SSR or relay.
+#define HEATING_DRIVE_LEDC 0
+#define HEATING_DRIVE_WINDOW 1
+#ifndef HEATING_DRIVE
+#define HEATING_DRIVE HEATING_DRIVE_LEDC
+#endif
+
+/**
+ * @brief Heater control law of the control task.
+ */
+typedef enum {
+  HEATING_MODE_BANG_BANG,  ///< Full on while the predicted temperature is below the setpoint
+  HEATING_MODE_PID         ///< PID on the estimated temperature, proportional power
+} HEATING_MODE_t;
+
+/**
+ * @struct HEATING_PID_t
+ * @brief  PID gains and timing. Output is heater power in percent.
+ */
+typedef struct {
+  float kp;               ///< % per °C of error
+  float ki;               ///< % per °C·s of accumulated error
+  float kd;               ///< % per °C/s of temperature change (on measurement)
+  uint32_t sample_ms;     ///< Controller period
+  float ramp_rate;        ///< Setpoint slew limit in °C/s, 0 = step to the target
+} HEATING_PID_t;
 
 /**
  * @brief Initializes GPIO for heating pad control and sets up ADC.
  *
  * Configures the GPIO pin used to control the heater and sets it LOW (off).
- * Prepares internal buffer states for moving average filtering.
+ * Starts background sampling of the thermistor (HEATING_ADC.h) and the
+ * control task. Call before any other HEATING_ function.
  */
 void HEATING_Init(void);
 
 /**
- * @brief Reads a single raw MV value from the configured thermistor pin.
+ * @brief Latest MV value from the configured thermistor pin.
  *
- * This function performs a direct analog read of the voltage divider output.
+ * One oversampled block from the background ADC; does not wait for a
+ * conversion.
  *
  * @return Raw MV value (range: 0-3300 mV)
  *         or 0 if the read fails
@@ -41,9 +74,10 @@ int HEATING_Measure_Raw_MV(void);
 /**
  * @brief Returns the moving average of raw MV readings.
  *
- * Smooths out rapid fluctuations by averaging over a window of samples.
+ * Smooths out rapid fluctuations by averaging over a window of uniformly
+ * spaced samples, kept up to date by the background ADC.
  *
- *  @return Average MV value (range: 0-3300 mV)
+ *  @return Average divider output in Volts (range: 0-3.3 V)
  *         or 0 if the read fails
  */
 float HEATING_Measure_AVG_MV(void);
@@ -60,28 +94,77 @@ float HEATING_Measure_AVG_MV(void);
 float HEATING_Measure_Resistance(void);
 
 /**
- * @brief Converts thermistor resistance to temperature using the BETA model.
+ * @brief Converts the divider output to temperature.
  *
- * Applies the simplified Steinhart-Hart BETA equation to determine temperature.
+ * Uses the compile-time lookup table in THERMISTOR.h (BETA model, or
+ * Steinhart-Hart with THERMISTOR_MODEL); constant time, no log().
  *
  * @return Temperature in degrees Celsius
  */
 float HEATING_Measure_Temp(void);
 
 /**
- * @brief Returns a moving average of recent temperature readings.
+ * @brief Returns the temperature of the averaged divider output.
  *
  * Reduces measurement noise and improves stability for control decisions.
+ * Constant time; the result does not depend on the call rate.
  *
  * @return Averaged temperature in degrees Celsius
  */
 float HEATING_Measure_Temp_Avg(void);
 
 /**
- * @brief Bang-bang control: toggles heater based on target temperature.
+ * @brief Kalman estimate of the temperature (HEATING_ESTIMATOR.h).
  *
- * If the measured temperature is below the setpoint, turns the heater ON.
- * If the measured temperature is at or above the setpoint, turns it OFF.
+ * Updated with every ADC sample; lower lag than HEATING_Measure_Temp_Avg()
+ * at similar noise. Falls back to the average until the first sample.
+ *
+ * @return Temperature in degrees Celsius
+ */
+float HEATING_Estimate_Temp(void);
+
+/**
+ * @brief Kalman estimate of the temperature's rate of change.
+ *
+ * @return °C per second, positive while heating
+ */
+float HEATING_Estimate_Rate(void);
+
+/**
+ * @brief Relay autotune progress, see HEATING_Autotune_Status().
+ */
+typedef enum {
+  HEATING_AUTOTUNE_IDLE,     ///< Not started or cancelled
+  HEATING_AUTOTUNE_RUNNING,  ///< Relay oscillation in progress
+  HEATING_AUTOTUNE_DONE,     ///< Gains computed and applied
+  HEATING_AUTOTUNE_FAILED    ///< Timed out, overheated or no usable oscillation
+} HEATING_AUTOTUNE_STATUS_t;
+
+/**
+ * @struct HEATING_AUTOTUNE_t
+ * @brief  Autotune progress and result.
+ */
+typedef struct {
+  HEATING_AUTOTUNE_STATUS_t status;
+  float setpoint;         ///< Temperature the relay switches around
+  int cycles;             ///< Full oscillations seen so far
+  int totalCycles;        ///< Oscillations needed
+  float amplitude;        ///< Measured peak amplitude (°C), 0 until known
+  float ku;               ///< Ultimate gain (% per °C)
+  float tu;               ///< Ultimate period (s)
+  HEATING_PID_t pid;      ///< Gains computed from ku / tu
+} HEATING_AUTOTUNE_t;
+
+/**
+ * @brief Regulates to a setpoint until HEATING_Off().
+ *
+ * Only a command: the control task does the work every 50 ms, whatever
+ * the caller is doing. Calling again with a new setpoint changes the target
+ * without restarting the controller.
+ *
+ * In PID mode a new power is computed every sample_ms. In bang-bang mode
+ * the heater is at full power while the temperature predicted a short lead
+ * ahead (estimate + rate x lead) is below the setpoint, off otherwise.
  *
  * @param setpointCelsius Desired target temperature in °C
  */
@@ -90,7 +173,96 @@ void HEATING_Set_Temp(int setpointCelsius);
 /**
  * @brief Turns off temperature controller.
  *
+ * Also resets the PID state, so the next HEATING_Set_Temp() starts a new
+ * setpoint ramp from the current temperature with no integral carried over.
  */
 void HEATING_Off();
 
+/**
+ * @brief Selects the control law (takes effect on the next control step).
+ *
+ * Bang-bang by default; HEATING_Init() selects PID if NVS holds gains, and
+ * so does a successful autotune.
+ */
+void HEATING_Set_Mode(HEATING_MODE_t mode);
+
+/**
+ * @brief Returns the active control law.
+ */
+HEATING_MODE_t HEATING_Get_Mode(void);
+
+/**
+ * @brief Replaces the PID gains and timing; resets the controller state.
+ */
+void HEATING_Set_PID(const HEATING_PID_t *pid);
+
+/**
+ * @brief Returns the current PID gains and timing.
+ */
+const HEATING_PID_t *HEATING_Get_PID(void);
+
+/**
+ * @brief Sets the heater power directly (controllers call this too).
+ *
+ * Delivered by the HEATING_DRIVE output independently of loop() timing,
+ * so the heater keeps its power while the main loop is busy. The control
+ * task overwrites it on its next step while regulating or autotuning.
+ *
+ * @param percent 0-100, clamped
+ */
+void HEATING_Set_Power(float percent);
+
+/**
+ * @brief Current heater power in percent (0 or 100 in bang-bang mode).
+ */
+float HEATING_Get_Output(void);
+
+/**
+ * @brief Starts a relay (Åström–Hägglund) autotune around a setpoint.
+ *
+ * The heater is switched fully on below setpoint - hysteresis and off
+ * above setpoint + hysteresis. Once the oscillation has settled, its
+ * amplitude and period give the ultimate gain Ku = 4d / (π·a) and period
+ * Tu, from which PID gains are computed. The control task drives the
+ * relay; follow it with HEATING_Autotune_Status().
+ *
+ * @param setpointCelsius Temperature to tune at (normally the run's target)
+ * @return false if the setpoint is out of range
+ */
+bool HEATING_Autotune_Start(float setpointCelsius);
+
+/**
+ * @brief Autotune progress.
+ *
+ * On DONE the new gains are already active, in PID mode (see
+ * HEATING_Save_PID()).
+ *
+ * @return Current status
+ */
+HEATING_AUTOTUNE_STATUS_t HEATING_Autotune_Status(void);
+
+/**
+ * @brief Stops a running autotune and turns the heater off.
+ */
+void HEATING_Autotune_Cancel(void);
+
+/**
+ * @brief Progress and result of the last autotune.
+ */
+const HEATING_AUTOTUNE_t *HEATING_Autotune_Get(void);
+
+/**
+ * @brief Stores the active PID gains in NVS.
+ *
+ * @return false if NVS could not be written
+ */
+bool HEATING_Save_PID(void);
+
+/**
+ * @brief Loads PID gains from NVS (called by HEATING_Init()).
+ *
+ * @return false if none are stored; the defaults stay active
+ */
+bool HEATING_Load_PID(void);
+
 #endif // HEATING_H
@@ -0,0 +1,195 @@
+/**
+ * @file    HEATING_ADC.cpp
+ * @brief   Background thermistor acquisition at a fixed sample rate
+ *
+ * ESP32-S3: ADC1 in continuous (DMA) mode, one frame per output sample, read
+ * by a task on core 0 so the Arduino loop on core 1 is never involved. The
+ * S3's digital controller has no oversampling stage, so each frame's
+ * conversions go through the block filter (HEATING_DSP.h) here and the
+ * result is converted to mV once, through the eFuse calibration.
+ *
+ * Date:   Oct 2026
+ */
+
+ #include <Arduino.h>
+ #include "HEATING_ADC.h"
+ #include "HEATING_DSP.h"
+ #if defined(ARDUINO_ARCH_ESP32)
+ #include <driver/adc.h>
+ #include <esp_adc_cal.h>
+ #endif
+
+ // === Filter State (written by the reader only) ===
+ static float averageBuffer[HEATING_ADC_AVERAGE_WINDOW] = {0};
+ static int averageIndex = 0, averageCount = 0;
+ static float averageSum = 0;
+
+ // === Published Results ===
+ static volatile float latestMv = 0;
+ static volatile float averageMv = 0;
+ static volatile uint32_t sampleCount = 0;
+ static volatile uint32_t overruns = 0;
+ static HEATING_ADC_HOOK_t sampleHook = NULL;
+
+ /**
+  * @brief Adds one output sample to the moving average and publishes both.
+  *
+  * The sum is updated incrementally and recomputed once per window so
+  * rounding cannot accumulate.
+  */
+ static void HEATING_ADC_Push(float mv) {
+   averageSum += mv - averageBuffer[averageIndex];
+   averageBuffer[averageIndex] = mv;
+   averageIndex = (averageIndex + 1) % HEATING_ADC_AVERAGE_WINDOW;
+   if (averageCount < HEATING_ADC_AVERAGE_WINDOW) averageCount++;
+
+   if (averageIndex == 0) {
+     averageSum = 0;
+     for (int i = 0; i < averageCount; i++) averageSum += averageBuffer[i];
+   }
+
+   latestMv = mv;
+   averageMv = averageSum / averageCount;
+   sampleCount = sampleCount + 1;
+   if (sampleHook) sampleHook(mv);
+ }
+
+ #if defined(ARDUINO_ARCH_ESP32)
+
+ #define HEATING_ADC_FRAME_BYTES (HEATING_ADC_OVERSAMPLE * SOC_ADC_DIGI_RESULT_BYTES)
+ #define HEATING_ADC_BUFFER_FRAMES 16    // DMA slack before an overrun (80 ms)
+ #define HEATING_ADC_TASK_STACK 3072
+ #define HEATING_ADC_TASK_PRIORITY 5
+ #define HEATING_ADC_TASK_CORE 0         // Arduino loop runs on core 1
+
+ static esp_adc_cal_characteristics_t calibration;
+ static adc_channel_t adcChannel;
+ static HEATING_DSP_t dsp;
+
+ /**
+  * @brief Calibrated mV for a fractional raw code (the filter output), by
+  *        interpolating between the two neighbouring codes.
+  */
+ static float HEATING_ADC_Code_To_MV(float code) {
+   uint32_t low = (uint32_t)code;
+   if (low >= 4095) return esp_adc_cal_raw_to_voltage(4095, &calibration);
+   float lowMv = esp_adc_cal_raw_to_voltage(low, &calibration);
+   float highMv = esp_adc_cal_raw_to_voltage(low + 1, &calibration);
+   return lowMv + (highMv - lowMv) * (code - low);
+ }
+
+ /**
+  * @brief Reader task: one DMA frame in, one filtered sample out.
+  */
+ static void HEATING_ADC_Task(void *arg) {
+   (void)arg;
+   static uint8_t frame[HEATING_ADC_FRAME_BYTES];
+   static float codes[HEATING_ADC_OVERSAMPLE];
+   float filtered[HEATING_ADC_OVERSAMPLE / HEATING_DSP_DECIMATION + 1];
+
+   for (;;) {
+     uint32_t length = 0;
+     esp_err_t result = adc_digi_read_bytes(frame, sizeof(frame), &length, portMAX_DELAY);
+     if (result == ESP_ERR_INVALID_STATE) overruns = overruns + 1;  // Data still valid
+     else if (result != ESP_OK) continue;
+
+     int count = 0;
+     for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length && count < HEATING_ADC_OVERSAMPLE; i += SOC_ADC_DIGI_RESULT_BYTES) {
+       const adc_digi_output_data_t *out = (const adc_digi_output_data_t *)&frame[i];
+       if (out->type2.unit != 0 || out->type2.channel != adcChannel) continue;
+       codes[count++] = out->type2.data;
+     }
+
+     int outputs = HEATING_DSP_Process(&dsp, codes, count, filtered);
+     for (int i = 0; i < outputs; i++) HEATING_ADC_Push(HEATING_ADC_Code_To_MV(filtered[i]));
+   }
+ }
+
+ bool HEATING_ADC_Init(int pin) {
+   int8_t channel = digitalPinToAnalogChannel(pin);
+   if (channel < 0 || channel >= SOC_ADC_CHANNEL_NUM(0)) {
+     Serial.printf("[HEATING_ADC] GPIO %d is not an ADC1 pin\n", pin);
+     return false;
+   }
+   adcChannel = (adc_channel_t)channel;
+
+   adc_digi_init_config_t init = {
+     .max_store_buf_size = HEATING_ADC_FRAME_BYTES * HEATING_ADC_BUFFER_FRAMES,
+     .conv_num_each_intr = HEATING_ADC_FRAME_BYTES,
+     .adc1_chan_mask = BIT(channel),
+     .adc2_chan_mask = 0,
+   };
+   if (adc_digi_initialize(&init) != ESP_OK) {
+     Serial.println("[HEATING_ADC] DMA driver init failed");
+     return false;
+   }
+
+   adc_digi_pattern_config_t pattern = {
+     .atten = ADC_ATTEN_DB_11,
+     .channel = (uint8_t)channel,
+     .unit = 0,  // ADC1
+     .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+   };
+   adc_digi_configuration_t config = {
+     .conv_limit_en = false,
+     .conv_limit_num = 250,
+     .pattern_num = 1,
+     .adc_pattern = &pattern,
+     .sample_freq_hz = HEATING_ADC_SAMPLE_HZ,
+     .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+     .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+   };
+   adc_digi_controller_configure(&config);
+   esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &calibration);
+   HEATING_DSP_Init(&dsp);
+
+   xTaskCreatePinnedToCore(HEATING_ADC_Task, "heating_adc", HEATING_ADC_TASK_STACK, NULL,
+                           HEATING_ADC_TASK_PRIORITY, NULL, HEATING_ADC_TASK_CORE);
+   adc_digi_start();
+   return true;
+ }
+
+ #else
+
+ static int adcPin = -1;
+ static hw_timer_t *sampleTimer = NULL;
+
+ /**
+  * @brief Sampling timer: one read per output sample.
+  */
+ static void IRAM_ATTR HEATING_ADC_Sample_ISR() {
+   HEATING_ADC_Push((float)analogReadMilliVolts(adcPin));
+ }
+
+ bool HEATING_ADC_Init(int pin) {
+   adcPin = pin;
+   analogReadResolution(12);
+   analogSetAttenuation(ADC_11db);
+   sampleTimer = timerBegin(HEATING_ADC_TIMER, 80, true);  // 1 tick per us
+   timerAttachInterrupt(sampleTimer, HEATING_ADC_Sample_ISR, true);
+   timerAlarmWrite(sampleTimer, 1000000ULL / HEATING_ADC_OUTPUT_HZ, true);
+   timerAlarmEnable(sampleTimer);
+   return true;
+ }
+
+ #endif
+
+ void HEATING_ADC_Set_Hook(HEATING_ADC_HOOK_t hook) {
+   sampleHook = hook;
+ }
+
+ float HEATING_ADC_Latest_MV(void) {
+   return latestMv;
+ }
+
+ float HEATING_ADC_Average_MV(void) {
+   return averageMv;
+ }
+
+ uint32_t HEATING_ADC_Sample_Count(void) {
+   return sampleCount;
+ }
+
+ uint32_t HEATING_ADC_Overruns(void) {
+   return overruns;
+ }
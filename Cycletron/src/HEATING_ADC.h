@@ -0,0 +1,72 @@
+/**
+ * @file    HEATING_ADC.h
+ * @brief   Background thermistor acquisition at a fixed sample rate
+ *
+ * The ADC runs continuously into DMA at HEATING_ADC_SAMPLE_HZ. A reader
+ * task filters and decimates each frame of HEATING_ADC_OVERSAMPLE
+ * conversions into one sample (HEATING_ADC_OUTPUT_HZ, uniformly spaced;
+ * see HEATING_DSP.h) and keeps a moving average of the last
+ * HEATING_ADC_AVERAGE_WINDOW of those. Readers only load the
+ * latest result, so taking a temperature never waits for the ADC.
+ *
+ * Native builds have no DMA: a hardware timer reads the pin once per
+ * output sample instead, feeding the same moving average at the same rate.
+ *
+ * Date:   Oct 2026
+ */
+
+ #ifndef HEATING_ADC_H
+ #define HEATING_ADC_H
+
+ #include <Arduino.h>
+
+ // === Acquisition ===
+ #define HEATING_ADC_SAMPLE_HZ 20000     // DMA conversion rate
+ #define HEATING_ADC_OVERSAMPLE 100      // Conversions averaged per output sample
+ #define HEATING_ADC_OUTPUT_HZ (HEATING_ADC_SAMPLE_HZ / HEATING_ADC_OVERSAMPLE)
+ #define HEATING_ADC_AVERAGE_WINDOW 80   // Output samples in the moving average (0.4 s)
+ #define HEATING_ADC_TIMER 2             // Native builds only: sampling timer
+
+ /**
+  * @brief Called with every output sample (mV), in the reader's context
+  *        (ADC task; sampling timer ISR on native builds).
+  */
+ typedef void (*HEATING_ADC_HOOK_t)(float mv);
+
+ /**
+  * @brief Starts continuous sampling of an ADC1 pin.
+  *
+  * @param pin GPIO of the thermistor divider
+  * @return false if the pin is not on ADC1 or the driver could not start
+  */
+ bool HEATING_ADC_Init(int pin);
+
+ /**
+  * @brief Sets the per-sample hook (NULL to remove). Set it before
+  *        HEATING_ADC_Init().
+  */
+ void HEATING_ADC_Set_Hook(HEATING_ADC_HOOK_t hook);
+
+ /**
+  * @brief Latest output sample (one filtered frame) in mV.
+  */
+ float HEATING_ADC_Latest_MV(void);
+
+ /**
+  * @brief Moving average of the output samples in mV.
+  *
+  * 0 until the first sample has arrived.
+  */
+ float HEATING_ADC_Average_MV(void);
+
+ /**
+  * @brief Output samples taken since HEATING_ADC_Init().
+  */
+ uint32_t HEATING_ADC_Sample_Count(void);
+
+ /**
+  * @brief Times the DMA buffer filled before the reader emptied it.
+  */
+ uint32_t HEATING_ADC_Overruns(void);
+
+ #endif // HEATING_ADC_H
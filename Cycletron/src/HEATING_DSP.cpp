@@ -0,0 +1,98 @@
+/**
+ * @file    HEATING_DSP.cpp
+ * @brief   Block filter for thermistor ADC frames
+ *
+ * The history is kept linear (previous TAPS-1 inputs followed by the new
+ * block) so every output is one contiguous dot product, which is what the
+ * esp-dsp kernels want. The window is symmetric, so the coefficients need
+ * no reversal.
+ *
+ * Date:   Oct 2026
+ */
+
+ #include <Arduino.h>
+ #include <math.h>
+ #include <string.h>
+ #include "HEATING_DSP.h"
+ #if defined(ARDUINO_ARCH_ESP32)
+ #include "dsps_dotprod.h"
+ #endif
+
+ #define HEATING_DSP_HISTORY (HEATING_DSP_TAPS - 1)
+
+ /**
+  * @brief Sum of a[i] * b[i].
+  */
+ static inline float HEATING_DSP_Dot(const float *a, const float *b, int length) {
+ #if defined(ARDUINO_ARCH_ESP32)
+   float result = 0;
+   dsps_dotprod_f32(a, b, &result, length);  // aes3 (PIE) variant on the S3
+   return result;
+ #else
+   float result = 0;
+   for (int i = 0; i < length; i++) result += a[i] * b[i];
+   return result;
+ #endif
+ }
+
+ /**
+  * @brief Median of three without branches on the data order.
+  */
+ static inline float HEATING_DSP_Median3(float a, float b, float c) {
+   return fmaxf(fminf(a, b), fminf(fmaxf(a, b), c));
+ }
+
+ void HEATING_DSP_Init(HEATING_DSP_t *dsp) {
+   // Hamming-windowed sinc, cutoff at the output Nyquist frequency
+   const float cutoff = 0.5f / HEATING_DSP_DECIMATION;  // Cycles per input sample
+   const float center = (HEATING_DSP_TAPS - 1) / 2.0f;
+   float sum = 0;
+   for (int i = 0; i < HEATING_DSP_TAPS; i++) {
+     float x = i - center;
+     float sinc = (x == 0) ? 2 * cutoff : sinf(2 * (float)M_PI * cutoff * x) / ((float)M_PI * x);
+     float window = 0.54f - 0.46f * cosf(2 * (float)M_PI * i / (HEATING_DSP_TAPS - 1));
+     dsp->coeffs[i] = sinc * window;
+     sum += dsp->coeffs[i];
+   }
+   for (int i = 0; i < HEATING_DSP_TAPS; i++) dsp->coeffs[i] /= sum;  // Unity DC gain
+
+   memset(dsp->history, 0, sizeof(dsp->history));
+   dsp->previous[0] = dsp->previous[1] = 0;
+   dsp->primed = false;
+   dsp->phase = 0;
+ }
+
+ int HEATING_DSP_Process(HEATING_DSP_t *dsp, const float *in, int count, float *out) {
+   if (count <= 0) return 0;
+   if (count > HEATING_DSP_MAX_BLOCK) count = HEATING_DSP_MAX_BLOCK;
+
+   if (!dsp->primed) {
+     for (int i = 0; i < HEATING_DSP_HISTORY; i++) dsp->history[i] = in[0];
+     dsp->previous[0] = dsp->previous[1] = in[0];
+     dsp->primed = true;
+   }
+
+   // Spike rejection: each input is replaced by the median of itself and
+   // the two before it (one sample of delay)
+   float *block = &dsp->history[HEATING_DSP_HISTORY];
+   float a = dsp->previous[0], b = dsp->previous[1];
+   for (int i = 0; i < count; i++) {
+     float c = in[i];
+     block[i] = HEATING_DSP_Median3(a, b, c);
+     a = b;
+     b = c;
+   }
+   dsp->previous[0] = a;
+   dsp->previous[1] = b;
+
+   // Low-pass, evaluated only where an output is due
+   int outputs = 0;
+   for (int i = 0; i < count; i++) {
+     if (++dsp->phase < HEATING_DSP_DECIMATION) continue;
+     dsp->phase = 0;
+     out[outputs++] = HEATING_DSP_Dot(&dsp->history[i], dsp->coeffs, HEATING_DSP_TAPS);
+   }
+
+   memmove(dsp->history, &dsp->history[count], HEATING_DSP_HISTORY * sizeof(float));
+   return outputs;
+ }
@@ -0,0 +1,60 @@
+/**
+ * @file    HEATING_DSP.h
+ * @brief   Block filter for thermistor ADC frames
+ *
+ * Turns a block of raw conversions into decimated samples in three steps:
+ * median-of-3 spike rejection, a windowed-sinc FIR low-pass, and
+ * decimation by HEATING_DSP_DECIMATION (only every Nth FIR output is
+ * computed). The FIR dot products go through esp-dsp, which uses the
+ * ESP32-S3's SIMD (PIE) instructions; host builds use a scalar loop.
+ *
+ * Date:   Oct 2026
+ */
+
+ #ifndef HEATING_DSP_H
+ #define HEATING_DSP_H
+
+ #include <Arduino.h>
+ #include "HEATING_ADC.h"
+
+ // === Filter ===
+ #define HEATING_DSP_TAPS 200                            // Two output periods of input
+ #define HEATING_DSP_DECIMATION HEATING_ADC_OVERSAMPLE   // Inputs per output
+ #define HEATING_DSP_MAX_BLOCK HEATING_ADC_OVERSAMPLE    // Inputs per HEATING_DSP_Process() call
+
+ /**
+  * @struct HEATING_DSP_t
+  * @brief  Filter state; one per input stream.
+  */
+ typedef struct {
+   float coeffs[HEATING_DSP_TAPS] __attribute__((aligned(16)));
+   float history[HEATING_DSP_TAPS - 1 + HEATING_DSP_MAX_BLOCK] __attribute__((aligned(16)));  ///< Last TAPS-1 inputs, then the block
+   float previous[2];   ///< Last two raw inputs, for the median across blocks
+   bool primed;         ///< False until the first block
+   int phase;           ///< Inputs since the last output
+ } HEATING_DSP_t;
+
+ /**
+  * @brief Designs the low-pass and clears the state.
+  *
+  * Cutoff is the output Nyquist frequency (input rate / decimation / 2),
+  * DC gain exactly 1. The first outputs see a history filled with the first
+  * input rather than zeros, so there is no start-up ramp.
+  *
+  * @param dsp Filter to initialize
+  */
+ void HEATING_DSP_Init(HEATING_DSP_t *dsp);
+
+ /**
+  * @brief Filters a block of inputs.
+  *
+  * @param dsp   Filter state
+  * @param in    Raw inputs (ADC codes or mV)
+  * @param count Number of inputs, at most HEATING_DSP_MAX_BLOCK
+  * @param out   Receives the decimated outputs, room for
+  *              count / HEATING_DSP_DECIMATION + 1
+  * @return Number of outputs written
+  */
+ int HEATING_DSP_Process(HEATING_DSP_t *dsp, const float *in, int count, float *out);
+
+ #endif // HEATING_DSP_H
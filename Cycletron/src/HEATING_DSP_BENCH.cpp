@@ -0,0 +1,274 @@
+/**
+ * @file    HEATING_DSP_BENCH.cpp
+ * @brief   Cost and quality of the thermistor filter chains
+ *
+ * Feeds the same synthetic ADC stream (DC, 50 Hz pickup, noise and single
+ * sample spikes at HEATING_ADC_SAMPLE_HZ) through three chains and reports
+ * the time per input sample and the worst output error after settling:
+ *
+ *   legacy  80-sample moving averages re-summed on every call, mV and then
+ *           temperature, as HEATING_Measure_Temp_Avg() used to do
+ *   mean    block mean of each frame plus the running-sum average
+ *   dsp     HEATING_DSP (median-of-3, FIR, decimation) plus the same average
+ *
+ * Build with `pio run -e dsp_bench` for the board (cycles per sample, esp-dsp
+ * SIMD kernels; output on Serial) or `pio run -e native_dsp_bench` for the
+ * host (ns per sample, scalar fallback), which exits non-zero if the DSP
+ * chain loses unity gain or rejects spikes no better than the block mean.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifdef HEATING_DSP_BENCH
+
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+#include "HEATING_ADC.h"
+#include "HEATING_DSP.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include "hal/cpu_hal.h"
+#define BENCH_NOW() cpu_hal_get_cycle_count()
+#define BENCH_UNIT "cycles"
+#else
+#include <chrono>
+#include "SIM_HAL.h"
+// Virtual cycles do not advance while host code runs, so time it for real
+static uint32_t BENCH_Host_Ns(void)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#define BENCH_NOW() BENCH_Host_Ns()
+#define BENCH_UNIT "ns"
+#endif
+
+// === Test Signal (ADC codes) ===
+#define BENCH_FRAMES 400                 // 2 s of input
+#define BENCH_SAMPLES (BENCH_FRAMES * HEATING_ADC_OVERSAMPLE)
+#define BENCH_DC 2000.0f
+#define BENCH_HUM 30.0f                  // 50 Hz amplitude
+#define BENCH_NOISE 6                    // Peak uniform noise
+#define BENCH_SPIKE 1200.0f              // Single-sample glitch...
+#define BENCH_SPIKE_EVERY 1013           // ...this often
+#define BENCH_SETTLE_FRAMES 40           // Outputs ignored while the averages fill
+#define BENCH_REPEATS 5                  // Timed passes, fastest kept
+
+// === Host Regression Limits ===
+#define BENCH_SIM_DC_ERROR 0.01f         // Codes, constant input
+
+// The old filter's window
+#define BENCH_LEGACY_WINDOW 80
+
+/**
+ * @struct BENCH_AVERAGE_t
+ * @brief  Running-sum moving average, as in HEATING_ADC.cpp.
+ */
+typedef struct
+{
+    float buffer[HEATING_ADC_AVERAGE_WINDOW];
+    int index;
+    int count;
+    float sum;
+} BENCH_AVERAGE_t;
+
+/**
+ * @struct BENCH_LEGACY_t
+ * @brief  Re-summed moving average, as the old HEATING_Measure_AVG_MV().
+ */
+typedef struct
+{
+    float buffer[BENCH_LEGACY_WINDOW];
+    int index;
+    int count;
+} BENCH_LEGACY_t;
+
+/**
+ * @struct BENCH_RESULT_t
+ * @brief  Figures for one chain.
+ */
+typedef struct
+{
+    float perSample; ///< Time per input sample (BENCH_UNIT)
+    float maxError;  ///< Worst |output - DC| after settling (codes)
+} BENCH_RESULT_t;
+
+static float benchInput[BENCH_SAMPLES];
+static float benchOutput[BENCH_SAMPLES];
+static HEATING_DSP_t benchDsp;
+
+/**
+ * @brief Builds the test stream (LCG noise, repeatable).
+ */
+static void BENCH_Make_Signal(bool constant)
+{
+    uint32_t seed = 0x1234567;
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+    {
+        float t = (float)i / HEATING_ADC_SAMPLE_HZ;
+        float x = BENCH_DC;
+        if (!constant)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            x += BENCH_HUM * sinf(2 * (float)M_PI * 50.0f * t);
+            x += (int)((seed >> 16) % (2 * BENCH_NOISE + 1)) - BENCH_NOISE;
+            if (i % BENCH_SPIKE_EVERY == BENCH_SPIKE_EVERY - 1)
+                x += BENCH_SPIKE;
+        }
+        benchInput[i] = roundf(x);
+    }
+}
+
+static float BENCH_Average_Push(BENCH_AVERAGE_t *a, float x)
+{
+    a->sum += x - a->buffer[a->index];
+    a->buffer[a->index] = x;
+    a->index = (a->index + 1) % HEATING_ADC_AVERAGE_WINDOW;
+    if (a->count < HEATING_ADC_AVERAGE_WINDOW)
+        a->count++;
+    return a->sum / a->count;
+}
+
+static float BENCH_Legacy_Push(BENCH_LEGACY_t *l, float x)
+{
+    l->buffer[l->index] = x;
+    l->index = (l->index + 1) % BENCH_LEGACY_WINDOW;
+    if (l->count < BENCH_LEGACY_WINDOW)
+        l->count++;
+
+    float sum = 0;
+    for (int i = 0; i < l->count; i++)
+        sum += l->buffer[i];
+    return sum / l->count;
+}
+
+/**
+ * @brief Old chain: two re-summed averages per sample.
+ *
+ * @return Outputs written (one per input)
+ */
+static int BENCH_Run_Legacy(void)
+{
+    static BENCH_LEGACY_t mv, temp;
+    memset(&mv, 0, sizeof(mv));
+    memset(&temp, 0, sizeof(temp));
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+        benchOutput[i] = BENCH_Legacy_Push(&temp, BENCH_Legacy_Push(&mv, benchInput[i]));
+    return BENCH_SAMPLES;
+}
+
+/**
+ * @brief HEATING_ADC chain from before the block filter: frame mean.
+ */
+static int BENCH_Run_Mean(void)
+{
+    static BENCH_AVERAGE_t average;
+    memset(&average, 0, sizeof(average));
+    int outputs = 0;
+    for (int f = 0; f < BENCH_FRAMES; f++)
+    {
+        const float *frame = &benchInput[f * HEATING_ADC_OVERSAMPLE];
+        float sum = 0;
+        for (int i = 0; i < HEATING_ADC_OVERSAMPLE; i++)
+            sum += frame[i];
+        benchOutput[outputs++] = BENCH_Average_Push(&average, sum / HEATING_ADC_OVERSAMPLE);
+    }
+    return outputs;
+}
+
+/**
+ * @brief Current chain: HEATING_DSP per frame.
+ */
+static int BENCH_Run_Dsp(void)
+{
+    static BENCH_AVERAGE_t average;
+    memset(&average, 0, sizeof(average));
+    HEATING_DSP_Init(&benchDsp);
+    int outputs = 0;
+    float filtered[HEATING_ADC_OVERSAMPLE / HEATING_DSP_DECIMATION + 1];
+    for (int f = 0; f < BENCH_FRAMES; f++)
+    {
+        int n = HEATING_DSP_Process(&benchDsp, &benchInput[f * HEATING_ADC_OVERSAMPLE], HEATING_ADC_OVERSAMPLE, filtered);
+        for (int i = 0; i < n; i++)
+            benchOutput[outputs++] = BENCH_Average_Push(&average, filtered[i]);
+    }
+    return outputs;
+}
+
+/**
+ * @brief Times a chain over the stream and measures its error.
+ *
+ * @param run         Chain to run
+ * @param perFrame    Outputs per frame (to skip the settling time)
+ */
+static BENCH_RESULT_t BENCH_Measure(int (*run)(void), int perFrame)
+{
+    BENCH_RESULT_t result = {0, 0};
+    uint32_t best = UINT32_MAX;
+    int outputs = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        uint32_t start = BENCH_NOW();
+        outputs = run();
+        uint32_t elapsed = BENCH_NOW() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    result.perSample = (float)best / BENCH_SAMPLES;
+
+    for (int i = BENCH_SETTLE_FRAMES * perFrame; i < outputs; i++)
+    {
+        float error = fabsf(benchOutput[i] - BENCH_DC);
+        if (error > result.maxError)
+            result.maxError = error;
+    }
+    return result;
+}
+
+static void BENCH_Print(const char *name, const BENCH_RESULT_t *r, const BENCH_RESULT_t *legacy)
+{
+    Serial.printf("%-7s %10.2f %8.1fx %10.2f\n", name, r->perSample,
+                  r->perSample > 0 ? legacy->perSample / r->perSample : 0.0f, r->maxError);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(2000); // Allow USB Serial to connect
+
+    Serial.printf("[BENCH] Thermistor filters, %d samples at %d Hz, %d taps, decimation %d\n",
+                  BENCH_SAMPLES, HEATING_ADC_SAMPLE_HZ, HEATING_DSP_TAPS, HEATING_DSP_DECIMATION);
+    Serial.printf("chain   %s/sample  speedup  max error\n", BENCH_UNIT);
+
+    BENCH_Make_Signal(false);
+    BENCH_RESULT_t legacy = BENCH_Measure(BENCH_Run_Legacy, HEATING_ADC_OVERSAMPLE);
+    BENCH_RESULT_t mean = BENCH_Measure(BENCH_Run_Mean, 1);
+    BENCH_RESULT_t dsp = BENCH_Measure(BENCH_Run_Dsp, 1);
+    BENCH_Print("legacy", &legacy, &legacy);
+    BENCH_Print("mean", &mean, &legacy);
+    BENCH_Print("dsp", &dsp, &legacy);
+
+    BENCH_Make_Signal(true);
+    BENCH_RESULT_t flat = BENCH_Measure(BENCH_Run_Dsp, 1);
+    Serial.printf("[BENCH] dsp DC error %.4f codes\n", flat.maxError);
+
+    int failures = 0;
+#if !defined(ARDUINO_ARCH_ESP32)
+    if (flat.maxError > BENCH_SIM_DC_ERROR)
+        failures++;
+    if (dsp.maxError >= mean.maxError)
+        failures++;
+#endif
+    Serial.printf("[BENCH] Done, %d failed check(s)\n", failures);
+#if !defined(ARDUINO_ARCH_ESP32)
+    SIM_Finish(failures ? 1 : 0);
+#endif
+}
+
+void loop()
+{
+    delay(1000);
+}
+
+#endif // HEATING_DSP_BENCH
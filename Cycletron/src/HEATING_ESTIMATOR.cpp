@@ -0,0 +1,69 @@
+/**
+ * @file    HEATING_ESTIMATOR.cpp
+ * @brief   Kalman filter tracking pad temperature and its rate of change
+ *
+ * Two states, one measurement, written out by hand: a few dozen flops per
+ * sample, no matrix library.
+ *
+ * Date:   Oct 2026
+ */
+
+ #include <Arduino.h>
+ #include "HEATING_ESTIMATOR.h"
+
+ void HEATING_ESTIMATOR_Init(HEATING_ESTIMATOR_t *est, float accelNoise, float measNoise) {
+   est->temp = 0;
+   est->rate = 0;
+   est->p[0][0] = est->p[0][1] = est->p[1][0] = est->p[1][1] = 0;
+   est->q = accelNoise * accelNoise;
+   est->r = measNoise * measNoise;
+   est->primed = false;
+   est->rejected = 0;
+   est->consecutive = 0;
+ }
+
+ void HEATING_ESTIMATOR_Update(HEATING_ESTIMATOR_t *est, float temp, float dt) {
+   if (!est->primed || est->consecutive >= HEATING_ESTIMATOR_MAX_REJECTS) {
+     est->temp = temp;
+     est->rate = 0;
+     est->p[0][0] = est->r;
+     est->p[0][1] = est->p[1][0] = 0;
+     est->p[1][1] = HEATING_ESTIMATOR_RATE_VAR;
+     est->primed = true;
+     est->consecutive = 0;
+     return;
+   }
+
+   // Predict: x = F x, P = F P F' + Q with F = [1 dt; 0 1]
+   est->temp += est->rate * dt;
+   float p00 = est->p[0][0] + dt * (est->p[0][1] + est->p[1][0]) + dt * dt * est->p[1][1];
+   float p01 = est->p[0][1] + dt * est->p[1][1];
+   float p10 = est->p[1][0] + dt * est->p[1][1];
+   float p11 = est->p[1][1];
+   p00 += est->q * dt * dt * dt / 3.0f;
+   p01 += est->q * dt * dt / 2.0f;
+   p10 += est->q * dt * dt / 2.0f;
+   p11 += est->q * dt;
+
+   // Correct with the temperature measurement (H = [1 0])
+   float innovation = temp - est->temp;
+   float s = p00 + est->r;
+   if (innovation * innovation > HEATING_ESTIMATOR_GATE * HEATING_ESTIMATOR_GATE * s) {
+     est->rejected++;
+     est->consecutive++;
+     est->p[0][0] = p00;
+     est->p[0][1] = p01;
+     est->p[1][0] = p10;
+     est->p[1][1] = p11;
+     return;
+   }
+   est->consecutive = 0;
+   float k0 = p00 / s;
+   float k1 = p10 / s;
+   est->temp += k0 * innovation;
+   est->rate += k1 * innovation;
+   est->p[0][0] = p00 - k0 * p00;
+   est->p[0][1] = p01 - k0 * p01;
+   est->p[1][0] = p10 - k1 * p00;
+   est->p[1][1] = p11 - k1 * p01;
+ }
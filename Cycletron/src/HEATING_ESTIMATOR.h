@@ -0,0 +1,65 @@
+/**
+ * @file    HEATING_ESTIMATOR.h
+ * @brief   Kalman filter tracking pad temperature and its rate of change
+ *
+ * Constant-rate model: the temperature moves at `rate` and the rate drifts
+ * as white noise of density `q` (°C/s^2)^2/Hz. The pad is slow (about 10
+ * min time constant, at most ~0.2 °C/s at full power) and the sensor lag
+ * spreads every change of heater power over tens of seconds, so its rate
+ * wanders by only millidegrees per second squared; that is what lets the
+ * filter average hard without the lag of a moving average on a ramp.
+ *
+ * Measurements more than HEATING_ESTIMATOR_GATE standard deviations off
+ * the prediction are treated as glitches and skipped; a run of
+ * HEATING_ESTIMATOR_MAX_REJECTS of them means the temperature really
+ * jumped (sensor reconnected, ...) and restarts the filter there.
+ *
+ * Date:   Oct 2026
+ */
+
+ #ifndef HEATING_ESTIMATOR_H
+ #define HEATING_ESTIMATOR_H
+
+ #include <Arduino.h>
+
+ // === Tuning (see the heater model in lib/SimHAL/src/SIM_BOARD.cpp) ===
+ #define HEATING_ESTIMATOR_ACCEL_NOISE 0.002f   // Rate drift, °C/s^2 (sqrt of q)
+ #define HEATING_ESTIMATOR_MEAS_NOISE 0.1f      // Per-sample temperature noise, °C (sqrt of r)
+ #define HEATING_ESTIMATOR_GATE 6.0f            // Outlier gate in standard deviations
+ #define HEATING_ESTIMATOR_RATE_VAR 1.0f        // Initial rate uncertainty, (°C/s)^2
+ #define HEATING_ESTIMATOR_MAX_REJECTS 20       // Consecutive outliers before a restart
+
+ /**
+  * @struct HEATING_ESTIMATOR_t
+  * @brief  Filter state.
+  */
+ typedef struct {
+   float temp;       ///< Estimated temperature (°C)
+   float rate;       ///< Estimated rate of change (°C/s)
+   float p[2][2];    ///< Estimate covariance
+   float q;          ///< Rate drift density
+   float r;          ///< Measurement variance
+   bool primed;      ///< False until the first measurement
+   uint32_t rejected;  ///< Measurements dropped by the gate
+   uint32_t consecutive;  ///< Current run of dropped measurements
+ } HEATING_ESTIMATOR_t;
+
+ /**
+  * @brief Clears the filter; the first measurement initializes it.
+  *
+  * @param est        Filter
+  * @param accelNoise Rate drift in °C/s^2
+  * @param measNoise  Measurement noise in °C
+  */
+ void HEATING_ESTIMATOR_Init(HEATING_ESTIMATOR_t *est, float accelNoise, float measNoise);
+
+ /**
+  * @brief Predicts `dt` ahead and corrects with one measurement.
+  *
+  * @param est  Filter
+  * @param temp Measured temperature (°C)
+  * @param dt   Seconds since the previous measurement
+  */
+ void HEATING_ESTIMATOR_Update(HEATING_ESTIMATOR_t *est, float temp, float dt);
+
+ #endif // HEATING_ESTIMATOR_H
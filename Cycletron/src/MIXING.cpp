@@ -10,6 +10,7 @@
 
  #include <Arduino.h>
  #include "MIXING.h"
+ #include "FAST_GPIO.h"
  
 
 //  #define TESTING_MIXING
@@ -22,6 +23,7 @@
  // Define motor GPIOs in an array for batch operations
  static const uint8_t motorPins[] = {MIX1_GPIO, MIX2_GPIO, MIX3_GPIO};
  static const int NUM_MOTORS = sizeof(motorPins) / sizeof(motorPins[0]);
+ static FAST_GPIO_MASK_t allMotorsMask = {0, 0};  // All motorPins, switched in one register write
  
  // === API IMPLEMENTATION ===
  
@@ -32,6 +34,7 @@
    for (int i = 0; i < NUM_MOTORS; i++) {
      pinMode(motorPins[i], OUTPUT);
      digitalWrite(motorPins[i], LOW);  // Motors off by default
+     FAST_GPIO_Add(&allMotorsMask, motorPins[i]);
    }
    Serial.println("[MIXING] All motors initialized and set to OFF");
  }
@@ -41,7 +44,7 @@
   * @param pin GPIO pin number
   */
  void MIXING_Motor_OnPin(uint8_t pin) {
-   digitalWrite(pin, HIGH);
+   FAST_GPIO_Write_Pin(pin, HIGH);
  }
  
  /**
@@ -49,25 +52,34 @@
   * @param pin GPIO pin number
   */
  void MIXING_Motor_OffPin(uint8_t pin) {
-   digitalWrite(pin, LOW);
+   FAST_GPIO_Write_Pin(pin, LOW);
  }
  
  /**
-  * @brief Turns ON all defined motors.
+  * @brief Turns ON several motors at the same instant.
+  * @param pins  GPIO pin numbers
+  * @param count Number of entries in pins
   */
- void MIXING_AllMotors_On() {
-   for (int i = 0; i < NUM_MOTORS; i++) {
-     digitalWrite(motorPins[i], HIGH);
+ void MIXING_Motors_OnPins(const uint8_t *pins, int count) {
+   FAST_GPIO_MASK_t mask = {0, 0};
+   for (int i = 0; i < count; i++) {
+     FAST_GPIO_Add(&mask, pins[i]);
    }
+   FAST_GPIO_Set(&mask);
+ }
+
+ /**
+  * @brief Turns ON all defined motors at the same instant.
+  */
+ void MIXING_AllMotors_On() {
+   FAST_GPIO_Set(&allMotorsMask);
  }
  
  /**
-  * @brief Turns OFF all defined motors.
+  * @brief Turns OFF all defined motors at the same instant.
   */
  void MIXING_AllMotors_Off() {
-   for (int i = 0; i < NUM_MOTORS; i++) {
-     digitalWrite(motorPins[i], LOW);
-   }
+   FAST_GPIO_Clear(&allMotorsMask);
  }
 
 // === TEST LOOP ===
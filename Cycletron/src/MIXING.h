@@ -41,17 +41,25 @@
   */
  void MIXING_Motor_OffPin(uint8_t pin);
  
+ /**
+  * @brief Turns ON a set of motors together in one register write.
+  *
+  * @param pins  GPIO pin numbers to turn ON.
+  * @param count Number of pins.
+  */
+ void MIXING_Motors_OnPins(const uint8_t *pins, int count);
+
  /**
   * @brief Turns ON all motors.
   *
-  * Drives all defined motor GPIO pins HIGH.
+  * Drives all defined motor GPIO pins HIGH in a single register write.
   */
  void MIXING_AllMotors_On();
  
  /**
   * @brief Turns OFF all motors.
   *
-  * Drives all defined motor GPIO pins LOW.
+  * Drives all defined motor GPIO pins LOW in a single register write.
   */
  void MIXING_AllMotors_Off();
  
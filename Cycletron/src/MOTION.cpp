@@ -0,0 +1,655 @@
+/**
+ * @file    MOTION.cpp
+ * @brief   Per-axis motion queues and completion events
+ *
+ * The scheduler runs in its own task (started by the first
+ * MOTION_Register_Axis()): it polls each axis' step engine for completion
+ * every MOTION_TASK_PERIOD_MS while anything moves, starts the next queued
+ * command, and sleeps otherwise. Pulse generation itself stays in the
+ * DRV8825 timer ISRs, one timer per axis, which is what lets both axes move
+ * at once.
+ *
+ * Callers in other tasks share the axis state under a mutex. Finished moves
+ * go back through a queue and are delivered (callback or event) by
+ * MOTION_Service() in the caller's task, so callbacks run where the state
+ * machine lives; an axis does not start its next move until the previous
+ * move's callback has run, as callbacks may queue moves or re-zero it.
+ *
+ * Each axis also tracks where the DRV8825 indexer sits within a full step.
+ * After a mode change the driver's first STEP edge only goes as far as the
+ * next valid state of the new mode, so a move that starts between steps
+ * makes a short first step; positions book that, and full-step travel only
+ * starts on a full-step boundary.
+ *
+ * Date:   Oct 2026
+ */
+
+#include <Arduino.h>
+#include "MOTION.h"
+#include "DRV8825.h"
+#include "globals.h"
+#include "send_functions.h"
+
+static const char *const axisNames[MOTION_AXIS_COUNT] = {"carriage", "syringe"};
+
+/**
+ * @brief Scheduler state for one axis.
+ */
+typedef struct
+{
+    DRV8825_t *motor;                             ///< Motor driving the axis
+    MOTION_COMMAND_t queue[MOTION_QUEUE_SIZE];    ///< Pending commands (ring buffer)
+    MOTION_HANDLE_t handles[MOTION_QUEUE_SIZE];   ///< Handles of pending commands
+    uint8_t head;                                 ///< Index of the oldest pending command
+    uint8_t count;                                ///< Number of pending commands
+    MOTION_HANDLE_t active;                       ///< Handle of the running move, 0 if idle
+    MOTION_COMMAND_t activeCmd;                   ///< Command of the running move
+    int activeDirection;                          ///< Direction resolved when the move started
+    int32_t activeStepSize;                       ///< Signed position change per step of the running segment
+    int32_t position;                             ///< Position before the running segment (1/MOTION_MICROSTEPS steps)
+    int32_t startPosition;                        ///< Position when the running move started
+    int32_t phase;                                ///< Indexer position within a full step before the running segment, 0 = on one
+    int32_t travel;                               ///< Distance the running move asked for (MOTION_MICROSTEPS units)
+    int coarseSteps;                              ///< Full steps to run after the lead-in segment, 0 = none
+    bool approachPending;                         ///< Fine approach still to run after the coarse segment
+    uint8_t undelivered;                          ///< Finished moves whose callback has not run yet
+} MOTION_Axis_State_t;
+
+/**
+ * @brief A finished move on its way to MOTION_Service().
+ */
+typedef struct
+{
+    MOTION_EVENT_t event;
+    MOTION_CALLBACK_t callback;
+    void *context;
+} MOTION_DONE_t;
+
+static MOTION_Axis_State_t axes[MOTION_AXIS_COUNT];
+static uint32_t nextSequence = 1;
+
+static MOTION_EVENT_t events[MOTION_EVENT_SIZE];
+static uint8_t eventHead = 0;
+static uint8_t eventCount = 0;
+
+static MOTION_EVENT_t history[MOTION_HISTORY_SIZE];
+static uint8_t historyNext = 0;
+
+// === Task (all NULL until the first MOTION_Register_Axis()) ===
+static SemaphoreHandle_t motionLock = NULL;  // Axis state, queues and history
+static SemaphoreHandle_t motionWake = NULL;  // Ends the task's idle wait
+static QueueHandle_t motionDone = NULL;      // Finished moves for MOTION_Service()
+static MOTION_HOOK_t doneHook = NULL;
+
+static void MOTION_Lock(void)
+{
+    if (motionLock)
+        xSemaphoreTake(motionLock, portMAX_DELAY);
+}
+
+static void MOTION_Unlock(void)
+{
+    if (motionLock)
+        xSemaphoreGive(motionLock);
+}
+
+static void MOTION_Cancel_Locked(MOTION_AXIS_t axis);
+static void MOTION_Task(void *parameter);
+
+/**
+ * @brief Records a finished move and passes it to MOTION_Service(); lock held.
+ */
+static void MOTION_Complete(MOTION_AXIS_t axis, MOTION_HANDLE_t handle, MOTION_RESULT_t result, uint32_t steps,
+                            MOTION_CALLBACK_t callback, void *context)
+{
+    MOTION_DONE_t done = {.event = {.handle = handle, .axis = axis, .result = result, .steps = steps},
+                          .callback = callback,
+                          .context = context};
+    history[historyNext] = done.event;
+    historyNext = (historyNext + 1) % MOTION_HISTORY_SIZE;
+
+    if (xQueueSend(motionDone, &done, 0) != pdTRUE)
+    {
+        Serial.printf("[MOTION] Completion queue full, dropping %s axis result\n", axisNames[axis]);
+        return;
+    }
+    if (callback)
+        axes[axis].undelivered++;
+    if (doneHook)
+        doneHook();
+}
+
+/**
+ * @brief Reports one finished move in the caller's task: the fault report,
+ *        then its callback, or the event queue if it has none.
+ */
+static void MOTION_Deliver(const MOTION_DONE_t *done)
+{
+    const MOTION_EVENT_t *event = &done->event;
+    if (event->result == MOTION_RESULT_FAULT)
+    {
+        Serial.printf("[MOTION] DRV8825 fault on %s axis at step %lu\n", axisNames[event->axis],
+                      (unsigned long)event->steps);
+        setState(SystemState::ERROR);
+        sendMotorFault(axisNames[event->axis], event->steps);
+    }
+
+    if (done->callback)
+    {
+        done->callback(event, done->context);
+
+        // The axis has been holding its next move for this callback
+        MOTION_Lock();
+        axes[event->axis].undelivered--;
+        MOTION_Unlock();
+        xSemaphoreGive(motionWake);
+        return;
+    }
+
+    if (eventCount == MOTION_EVENT_SIZE)
+    {
+        // Drop the oldest event so the newest completion is never lost
+        Serial.println("[MOTION] Event queue full, dropping oldest event");
+        eventHead = (eventHead + 1) % MOTION_EVENT_SIZE;
+        eventCount--;
+    }
+    events[(eventHead + eventCount) % MOTION_EVENT_SIZE] = *event;
+    eventCount++;
+}
+
+/**
+ * @brief Sets the step mode and starts one constant-mode segment of a move.
+ */
+static bool MOTION_Start_Segment(MOTION_Axis_State_t *state, bool untilLimit, int steps, int direction,
+                                 int stepMode, const MOTION_PROFILE_t *profile)
+{
+    DRV8825_Set_Step_Mode(state->motor, stepMode);
+
+    bool started;
+    if (profile == NULL)
+        started = DRV8825_Move_Async(state->motor, steps, direction, DRV8825_DEFAULT_STEP_DELAY_US);
+    else if (untilLimit)
+        started = DRV8825_Move_Until_Limit_Async(state->motor, steps, direction, profile);
+    else
+        started = DRV8825_Move_Profile_Async(state->motor, steps, direction, profile);
+
+    int32_t stepSize = MOTION_Step_Size(stepMode);
+    state->activeStepSize = (direction == DRV8825_FORWARD) ? stepSize : -stepSize;
+    return started;
+}
+
+/**
+ * @brief Signed position change of the running segment after `steps` STEP edges.
+ *
+ * The first edge only reaches the next valid state of the segment's mode,
+ * which is a short step if the indexer sits between two.
+ */
+static int32_t MOTION_Segment_Travel(const MOTION_Axis_State_t *state, uint32_t steps)
+{
+    if (steps == 0)
+        return 0;
+    int32_t size = abs(state->activeStepSize);
+    int32_t offset = state->phase % size;
+    int32_t first;
+    if (state->activeStepSize > 0)
+        first = size - offset;
+    else
+        first = (offset != 0) ? offset : size;
+    int32_t travel = first + (int32_t)(steps - 1) * size;
+    return (state->activeStepSize > 0) ? travel : -travel;
+}
+
+/**
+ * @brief Books the steps of the segment that just stopped.
+ */
+static void MOTION_End_Segment(MOTION_Axis_State_t *state)
+{
+    int32_t travel = MOTION_Segment_Travel(state, DRV8825_Get_Steps_Done(state->motor));
+    state->position += travel;
+    state->phase = ((state->phase + travel) % MOTION_MICROSTEPS + MOTION_MICROSTEPS) % MOTION_MICROSTEPS;
+}
+
+/**
+ * @brief Steps of the running move so far, in its command's step mode.
+ *
+ * Derived from the position change, so it stays exact across the coarse
+ * (full step) and fine segments of an adaptive move.
+ */
+static uint32_t MOTION_Move_Steps(const MOTION_Axis_State_t *state)
+{
+    return (uint32_t)(abs(state->position - state->startPosition) / MOTION_Step_Size(state->activeCmd.step_mode));
+}
+
+/**
+ * @brief Starts a command on an idle axis. Completes it immediately if it
+ *        cannot (or need not) run.
+ *
+ * With a coarse_profile, everything but the last approach_steps is covered
+ * in whole full steps first; MOTION_Step() then runs the remainder at the
+ * command's step mode. If the indexer is between full steps, a lead-in at
+ * the command's mode (1/32 for limit moves, whose length need not be
+ * exact) reaches the next one first; if that is not possible the whole
+ * move runs at the command's mode.
+ */
+static void MOTION_Start(MOTION_AXIS_t axis, MOTION_HANDLE_t handle, const MOTION_COMMAND_t *cmd)
+{
+    MOTION_Axis_State_t *state = &axes[axis];
+
+    // Limit move that starts on its switch: the RISING edge will never come
+    if (cmd->type == MOTION_MOVE_UNTIL_LIMIT && cmd->limit_pin >= 0 && digitalRead(cmd->limit_pin) == HIGH)
+    {
+        MOTION_Complete(axis, handle, MOTION_RESULT_LIMIT, 0, cmd->on_complete, cmd->context);
+        return;
+    }
+
+    int steps = cmd->steps;
+    int direction = cmd->direction;
+    int32_t stepSize = MOTION_Step_Size(cmd->step_mode);
+    if (cmd->type == MOTION_MOVE_TO)
+    {
+        // Resolved now, not at enqueue time, so moves queued ahead are accounted for
+        int32_t delta = (int32_t)cmd->steps * stepSize - state->position;
+        direction = (delta >= 0) ? DRV8825_FORWARD : DRV8825_BACKWARD;
+        steps = (int)(abs(delta) / stepSize);
+        if (steps == 0)
+        {
+            MOTION_Complete(axis, handle, MOTION_RESULT_DONE, 0, cmd->on_complete, cmd->context);
+            return;
+        }
+    }
+
+    // Split off the coarse travel: whole full steps from a full-step boundary,
+    // stopping approach_steps short
+    bool untilLimit = (cmd->type == MOTION_MOVE_UNTIL_LIMIT);
+    int32_t travel = (int32_t)steps * stepSize;
+    int leadMode = cmd->step_mode;
+    int leadSteps = 0;
+    int coarseSteps = 0;
+    if (cmd->coarse_profile != NULL)
+    {
+        int32_t lead = (direction == DRV8825_FORWARD) ? (MOTION_MICROSTEPS - state->phase) % MOTION_MICROSTEPS
+                                                      : state->phase;
+        if (lead % stepSize != 0 && untilLimit)
+            leadMode = DRV8825_THIRTYSECOND_STEP;
+        if (lead % MOTION_Step_Size(leadMode) == 0)
+        {
+            int32_t coarse = (travel - lead - (int32_t)cmd->approach_steps * stepSize) / MOTION_MICROSTEPS;
+            if (coarse > 0)
+            {
+                leadSteps = (int)(lead / MOTION_Step_Size(leadMode));
+                coarseSteps = (int)coarse;
+            }
+        }
+    }
+
+    bool started;
+    if (leadSteps > 0)
+    {
+        // The limit ISR still guards the lead-in and coarse segments; they just end at a fixed count
+        started = MOTION_Start_Segment(state, false, leadSteps, direction, leadMode, cmd->profile);
+        state->coarseSteps = coarseSteps;
+        state->approachPending = true;
+    }
+    else if (coarseSteps > 0)
+    {
+        started = MOTION_Start_Segment(state, false, coarseSteps, direction, DRV8825_FULL_STEP, cmd->coarse_profile);
+        state->coarseSteps = 0;
+        state->approachPending = true;
+    }
+    else
+    {
+        started = MOTION_Start_Segment(state, untilLimit, steps, direction, cmd->step_mode, cmd->profile);
+        state->coarseSteps = 0;
+        state->approachPending = false;
+    }
+
+    if (!started)
+    {
+        MOTION_Complete(axis, handle, MOTION_RESULT_REJECTED, 0, cmd->on_complete, cmd->context);
+        return;
+    }
+
+    state->active = handle;
+    state->activeCmd = *cmd;
+    state->activeDirection = direction;
+    state->startPosition = state->position;
+    state->travel = travel;
+}
+
+/**
+ * @brief Attaches a DRV8825 motor to an axis.
+ */
+void MOTION_Register_Axis(MOTION_AXIS_t axis, DRV8825_t *motor)
+{
+    if (motionLock == NULL)
+    {
+        motionLock = xSemaphoreCreateMutex();
+        motionWake = xSemaphoreCreateBinary();
+        motionDone = xQueueCreate(MOTION_DONE_QUEUE_SIZE, sizeof(MOTION_DONE_t));
+        xTaskCreatePinnedToCore(MOTION_Task, "motion", MOTION_TASK_STACK, NULL, MOTION_TASK_PRIORITY, NULL,
+                                MOTION_TASK_CORE);
+    }
+    MOTION_Lock();
+    axes[axis].motor = motor;
+    MOTION_Unlock();
+}
+
+void MOTION_Set_Done_Hook(MOTION_HOOK_t hook)
+{
+    doneHook = hook;
+}
+
+/**
+ * @brief Queues a move on an axis and returns its handle.
+ */
+MOTION_HANDLE_t MOTION_Enqueue(MOTION_AXIS_t axis, const MOTION_COMMAND_t *cmd)
+{
+    MOTION_Axis_State_t *state = &axes[axis];
+    if (state->motor == NULL)
+    {
+        Serial.printf("[MOTION] Axis %d has no motor\n", (int)axis);
+        return 0;
+    }
+
+    MOTION_Lock();
+    if (state->count == MOTION_QUEUE_SIZE)
+    {
+        MOTION_Unlock();
+        Serial.printf("[MOTION] Axis %d queue full\n", (int)axis);
+        return 0;
+    }
+
+    MOTION_HANDLE_t handle = (nextSequence++ << 2) | (uint32_t)axis;
+    uint8_t slot = (state->head + state->count) % MOTION_QUEUE_SIZE;
+    state->queue[slot] = *cmd;
+    state->handles[slot] = handle;
+    state->count++;
+    MOTION_Unlock();
+    xSemaphoreGive(motionWake);
+    return handle;
+}
+
+/**
+ * @brief Finishes completed moves and starts the next one on each idle axis;
+ *        motion task, lock held.
+ *
+ * @return true while any axis is moving
+ */
+static bool MOTION_Step(void)
+{
+    bool moving = false;
+    for (int i = 0; i < MOTION_AXIS_COUNT; i++)
+    {
+        MOTION_AXIS_t axis = (MOTION_AXIS_t)i;
+        MOTION_Axis_State_t *state = &axes[i];
+        if (state->motor == NULL)
+            continue;
+
+        if (state->active != 0 && !DRV8825_Is_Busy(state->motor))
+        {
+            const MOTION_COMMAND_t *cmd = &state->activeCmd;
+            bool untilLimit = (cmd->type == MOTION_MOVE_UNTIL_LIMIT);
+            MOTION_End_Segment(state);
+            bool segmentsLeft = (state->coarseSteps > 0 || state->approachPending);
+
+            MOTION_RESULT_t result;
+            if (DRV8825_Fault_Hit(state->motor))
+                result = MOTION_RESULT_FAULT;
+            else if (DRV8825_Limit_Hit(state->motor))
+                result = MOTION_RESULT_LIMIT;
+            else if (untilLimit && segmentsLeft && cmd->limit_pin >= 0 && digitalRead(cmd->limit_pin) == HIGH)
+                result = MOTION_RESULT_LIMIT; // Switch closed between the segments, no edge to catch
+            else if (state->coarseSteps > 0)
+            {
+                // On a full step now: cover the travel in full steps
+                int coarse = state->coarseSteps;
+                state->coarseSteps = 0;
+                if (MOTION_Start_Segment(state, false, coarse, state->activeDirection, DRV8825_FULL_STEP, cmd->coarse_profile))
+                {
+                    moving = true;
+                    continue;
+                }
+                result = MOTION_RESULT_REJECTED;
+            }
+            else if (state->approachPending && abs(state->position - state->startPosition) < state->travel)
+            {
+                // Coarse travel done: switch to the fine mode for the final approach
+                int32_t stepSize = MOTION_Step_Size(cmd->step_mode);
+                int fine = (int)((state->travel - abs(state->position - state->startPosition)) / stepSize);
+                state->approachPending = false;
+                if (fine > 0 && MOTION_Start_Segment(state, untilLimit, fine, state->activeDirection, cmd->step_mode, cmd->profile))
+                {
+                    moving = true;
+                    continue;
+                }
+                result = (fine > 0) ? MOTION_RESULT_REJECTED : (untilLimit ? MOTION_RESULT_NO_LIMIT : MOTION_RESULT_DONE);
+            }
+            else if (untilLimit)
+                result = MOTION_RESULT_NO_LIMIT;
+            else
+                result = MOTION_RESULT_DONE;
+
+            uint32_t steps = MOTION_Move_Steps(state);
+            MOTION_HANDLE_t handle = state->active;
+            state->active = 0;
+
+            MOTION_Complete(axis, handle, result, steps, cmd->on_complete, cmd->context);
+            if (result == MOTION_RESULT_FAULT)
+                MOTION_Cancel_Locked(axis); // Don't run the rest of the queue into a faulted driver
+        }
+
+        // Commands that complete immediately (already at limit, rejected) fall through to the next
+        while (state->active == 0 && state->count > 0 && state->undelivered == 0)
+        {
+            MOTION_COMMAND_t cmd = state->queue[state->head];
+            MOTION_HANDLE_t handle = state->handles[state->head];
+            state->head = (state->head + 1) % MOTION_QUEUE_SIZE;
+            state->count--;
+            MOTION_Start(axis, handle, &cmd);
+        }
+        if (state->active != 0)
+            moving = true;
+    }
+    return moving;
+}
+
+/**
+ * @brief Motion task: steps the scheduler while anything moves, otherwise
+ *        sleeps until a move is queued or a callback has run.
+ */
+static void MOTION_Task(void *parameter)
+{
+    (void)parameter;
+    for (;;)
+    {
+        xSemaphoreTake(motionLock, portMAX_DELAY);
+        bool moving = MOTION_Step();
+        xSemaphoreGive(motionLock);
+
+        if (moving)
+            vTaskDelay(pdMS_TO_TICKS(MOTION_TASK_PERIOD_MS));
+        else
+            xSemaphoreTake(motionWake, portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief Delivers finished moves in the caller's task.
+ */
+void MOTION_Service()
+{
+    MOTION_DONE_t done;
+    while (motionDone != NULL && xQueueReceive(motionDone, &done, 0) == pdTRUE)
+        MOTION_Deliver(&done);
+}
+
+/**
+ * @brief Pops the oldest completion event.
+ */
+bool MOTION_Poll_Event(MOTION_EVENT_t *event)
+{
+    if (eventCount == 0)
+        return false;
+
+    *event = events[eventHead];
+    eventHead = (eventHead + 1) % MOTION_EVENT_SIZE;
+    eventCount--;
+    return true;
+}
+
+/**
+ * @brief Returns the axis position, including the running move.
+ */
+int32_t MOTION_Get_Position(MOTION_AXIS_t axis)
+{
+    MOTION_Axis_State_t *state = &axes[axis];
+    MOTION_Lock();
+    int32_t position = state->position;
+    if (state->active != 0 && state->motor != NULL)
+        position += MOTION_Segment_Travel(state, DRV8825_Get_Steps_Done(state->motor));
+    MOTION_Unlock();
+    return position;
+}
+
+/**
+ * @brief Overwrites the axis position.
+ */
+void MOTION_Set_Position(MOTION_AXIS_t axis, int32_t position)
+{
+    MOTION_Lock();
+    axes[axis].position = position;
+    MOTION_Unlock();
+}
+
+/**
+ * @brief Returns true if nothing is running or queued on the axis.
+ *
+ * Reads without the lock, so plant models and ISRs may call it too.
+ */
+bool MOTION_Axis_Idle(MOTION_AXIS_t axis)
+{
+    return axes[axis].active == 0 && axes[axis].count == 0;
+}
+
+/**
+ * @brief Returns true while a handle is still running or queued; lock held.
+ */
+static bool MOTION_Is_Pending(MOTION_HANDLE_t handle)
+{
+    MOTION_Axis_State_t *state = &axes[MOTION_HANDLE_AXIS(handle)];
+    if (state->active == handle)
+        return true;
+    for (uint8_t i = 0; i < state->count; i++)
+    {
+        if (state->handles[(state->head + i) % MOTION_QUEUE_SIZE] == handle)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Reports whether a move is queued, running or finished.
+ */
+MOTION_STATUS_t MOTION_Get_Status(MOTION_HANDLE_t handle, MOTION_EVENT_t *event)
+{
+    if (handle == 0)
+        return MOTION_STATUS_UNKNOWN;
+
+    MOTION_STATUS_t status = MOTION_STATUS_UNKNOWN;
+    MOTION_Lock();
+    if (axes[MOTION_HANDLE_AXIS(handle)].active == handle)
+        status = MOTION_STATUS_RUNNING;
+    else if (MOTION_Is_Pending(handle))
+        status = MOTION_STATUS_QUEUED;
+    else
+    {
+        for (int i = 0; i < MOTION_HISTORY_SIZE; i++)
+        {
+            if (history[i].handle == handle)
+            {
+                if (event)
+                    *event = history[i];
+                status = MOTION_STATUS_DONE;
+                break;
+            }
+        }
+    }
+    MOTION_Unlock();
+    return status;
+}
+
+/**
+ * @brief Waits for one move to finish while keeping the other axes running.
+ */
+MOTION_RESULT_t MOTION_Wait(MOTION_HANDLE_t handle, MOTION_EVENT_t *event)
+{
+    MOTION_EVENT_t done = {.handle = handle, .axis = MOTION_HANDLE_AXIS(handle), .result = MOTION_RESULT_REJECTED, .steps = 0};
+    if (handle == 0)
+    {
+        // Enqueue refused the move
+        if (event)
+            *event = done;
+        return done.result;
+    }
+
+    MOTION_STATUS_t status;
+    while ((status = MOTION_Get_Status(handle, &done)) == MOTION_STATUS_QUEUED || status == MOTION_STATUS_RUNNING)
+    {
+        DRV8825_Idle();
+        MOTION_Service();
+    }
+    MOTION_Service(); // Its callback, if any
+
+    if (status != MOTION_STATUS_DONE)
+    {
+        // Too many moves finished since; the result is gone
+        Serial.printf("[MOTION] Result of %s axis move lost\n", axisNames[done.axis]);
+        done.result = MOTION_RESULT_UNKNOWN;
+        setState(SystemState::ERROR);
+        sendSystemError(ERROR_MOTION_RESULT_LOST);
+    }
+    if (event)
+        *event = done;
+    return done.result;
+}
+
+/**
+ * @brief Aborts the active move and cancels everything queued on the axis;
+ *        lock held.
+ */
+static void MOTION_Cancel_Locked(MOTION_AXIS_t axis)
+{
+    MOTION_Axis_State_t *state = &axes[axis];
+    if (state->motor == NULL)
+        return;
+
+    if (state->active != 0)
+    {
+        DRV8825_Abort(state->motor);
+        MOTION_End_Segment(state);
+        state->coarseSteps = 0;
+        state->approachPending = false;
+        MOTION_HANDLE_t handle = state->active;
+        state->active = 0;
+        MOTION_Complete(axis, handle, MOTION_RESULT_CANCELLED, MOTION_Move_Steps(state),
+                        state->activeCmd.on_complete, state->activeCmd.context);
+    }
+    while (state->count > 0)
+    {
+        MOTION_COMMAND_t cmd = state->queue[state->head];
+        MOTION_HANDLE_t handle = state->handles[state->head];
+        state->head = (state->head + 1) % MOTION_QUEUE_SIZE;
+        state->count--;
+        MOTION_Complete(axis, handle, MOTION_RESULT_CANCELLED, 0, cmd.on_complete, cmd.context);
+    }
+}
+
+/**
+ * @brief Aborts the active move and cancels everything queued on the axis.
+ */
+void MOTION_Cancel_Axis(MOTION_AXIS_t axis)
+{
+    MOTION_Lock();
+    MOTION_Cancel_Locked(axis);
+    MOTION_Unlock();
+}
@@ -0,0 +1,282 @@
+/**
+ * @file    MOTION.h
+ * @brief   Multi-axis motion scheduler for the DRV8825 axes
+ *
+ * Each axis (carriage, syringe) has its own command queue. The motion task
+ * starts the next queued move on every idle axis, so independent moves on
+ * different axes run at the same time on their own step timers. Finished
+ * moves are reported through a per-move callback, a completion event, or
+ * by polling the move's handle, so callers never have to block on motion;
+ * callbacks and events are delivered by MOTION_Service() in the caller's
+ * task, never in the motion task.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef MOTION_H
+#define MOTION_H
+
+#include <Arduino.h>
+#include "DRV8825.h"
+#include "MOTION_PROFILE.h"
+
+// === Scheduler Sizes ===
+#define MOTION_QUEUE_SIZE 4  // Pending moves per axis
+#define MOTION_EVENT_SIZE 8  // Completion events buffered for MOTION_Poll_Event()
+#define MOTION_HISTORY_SIZE 8  // Recent results kept for MOTION_Get_Status()
+
+// === Motion Task ===
+#define MOTION_TASK_CORE 1       // With the step timer ISRs; WiFi runs on core 0
+#define MOTION_TASK_PRIORITY 12  // Above the heating task
+#define MOTION_TASK_STACK 4096
+#define MOTION_TASK_PERIOD_MS 1  // Poll period while an axis is moving
+
+// === Position Units ===
+#define MOTION_MICROSTEPS 32  // Axis positions are kept in 1/32 steps (finest DRV8825 mode)
+
+/**
+ * @brief Motion axes known to the scheduler.
+ */
+typedef enum
+{
+    MOTION_AXIS_CARRIAGE = 0, ///< Movement motor (zones / vial access)
+    MOTION_AXIS_SYRINGE,      ///< Rehydration syringe pump
+    MOTION_AXIS_COUNT
+} MOTION_AXIS_t;
+
+// Finished moves waiting for MOTION_Service(): every queued move plus the running one on each axis
+#define MOTION_DONE_QUEUE_SIZE (MOTION_EVENT_SIZE + MOTION_AXIS_COUNT * (MOTION_QUEUE_SIZE + 1))
+
+/**
+ * @brief Kind of move a command performs.
+ */
+typedef enum
+{
+    MOTION_MOVE_STEPS,       ///< Move a fixed number of steps
+    MOTION_MOVE_UNTIL_LIMIT, ///< Move until the limit ISR halts the axis
+    MOTION_MOVE_TO           ///< Move to an absolute position (see MOTION_Get_Position())
+} MOTION_MOVE_t;
+
+/**
+ * @brief How a move ended.
+ */
+typedef enum
+{
+    MOTION_RESULT_DONE,     ///< All requested steps were sent
+    MOTION_RESULT_LIMIT,    ///< Stopped at a limit switch
+    MOTION_RESULT_NO_LIMIT, ///< Limit move ran out of steps without reaching the switch
+    MOTION_RESULT_REJECTED, ///< Driver refused to start the move
+    MOTION_RESULT_CANCELLED,///< Dropped by MOTION_Cancel_Axis()
+    MOTION_RESULT_FAULT,    ///< Aborted by the driver's FAULT line (already reported)
+    MOTION_RESULT_UNKNOWN   ///< MOTION_Wait() lost the result; position unknown (already reported)
+} MOTION_RESULT_t;
+
+/**
+ * @brief Identifies a queued move. 0 is never a valid handle.
+ *
+ * The low two bits hold the axis, the rest is a sequence number.
+ */
+typedef uint32_t MOTION_HANDLE_t;
+
+#define MOTION_HANDLE_AXIS(handle) ((MOTION_AXIS_t)((handle) & 0x3))
+
+/**
+ * @brief Where a queued move is in its life cycle.
+ */
+typedef enum
+{
+    MOTION_STATUS_QUEUED,  ///< Waiting behind other moves on its axis
+    MOTION_STATUS_RUNNING, ///< Step pulses are being generated
+    MOTION_STATUS_DONE,    ///< Finished; the event holds the result
+    MOTION_STATUS_UNKNOWN  ///< Invalid handle, or finished too long ago to remember
+} MOTION_STATUS_t;
+
+/**
+ * @struct MOTION_EVENT_t
+ * @brief  Completion event for one move.
+ */
+typedef struct
+{
+    MOTION_HANDLE_t handle; ///< Handle returned by MOTION_Enqueue()
+    MOTION_AXIS_t axis;     ///< Axis the move ran on
+    MOTION_RESULT_t result; ///< How the move ended
+    uint32_t steps;         ///< Steps actually sent
+} MOTION_EVENT_t;
+
+/**
+ * @brief Completion callback, run from MOTION_Service() in task context.
+ *
+ * It may queue further moves.
+ *
+ * @param event   How the move ended
+ * @param context Pointer given in the command
+ */
+typedef void (*MOTION_CALLBACK_t)(const MOTION_EVENT_t *event, void *context);
+
+/**
+ * @brief Called in the motion task when a finished move is waiting for
+ *        MOTION_Service(). Must not block or call into MOTION.
+ */
+typedef void (*MOTION_HOOK_t)(void);
+
+/**
+ * @struct MOTION_COMMAND_t
+ * @brief  One move request for an axis.
+ *
+ * Setting coarse_profile makes the move adaptive: it travels in full steps
+ * (fast, few interrupts) until approach_steps remain, then switches to
+ * step_mode for the final approach. The full steps start on a full-step
+ * boundary of the driver's indexer, after a short lead-in if needed. For
+ * MOTION_MOVE_UNTIL_LIMIT the approach is the last approach_steps of the
+ * safety cap, so the cap should be the expected distance plus a margin.
+ * Step counts and positions are always reported in step_mode units,
+ * whatever mode each part ran in.
+ */
+typedef struct
+{
+    MOTION_MOVE_t type;              ///< Fixed-length or move-until-limit
+    int steps;                       ///< Steps to move (safety cap for MOTION_MOVE_UNTIL_LIMIT, target for MOTION_MOVE_TO)
+    int direction;                   ///< DRV8825_FORWARD or DRV8825_BACKWARD (ignored for MOTION_MOVE_TO)
+    int step_mode;                   ///< DRV8825 microstep mode applied before the move
+    const MOTION_PROFILE_t *profile; ///< Speed limits, NULL = DRV8825_DEFAULT_STEP_DELAY_US
+    int limit_pin;                   ///< Switch guarding the move (HIGH = pressed), -1 if none
+    MOTION_CALLBACK_t on_complete;   ///< Called when the move ends, NULL = report via MOTION_Poll_Event()
+    void *context;                   ///< Passed to on_complete
+    const MOTION_PROFILE_t *coarse_profile; ///< Full-step travel profile, NULL = whole move at step_mode
+    int approach_steps;              ///< Final steps (step_mode) run fine after the coarse travel
+} MOTION_COMMAND_t;
+
+/**
+ * @brief Size of one step of a DRV8825 step mode, in MOTION_MICROSTEPS units.
+ *
+ * The DRV8825 runs modes 5, 6 and 7 (DRV8825_THIRTYSECOND_STEP) all at
+ * 1/32 step, so they all map to 1 and the result is never 0.
+ *
+ * @param step_mode DRV8825_FULL_STEP ... DRV8825_THIRTYSECOND_STEP
+ */
+static inline int32_t MOTION_Step_Size(int step_mode)
+{
+    return (step_mode >= 5) ? 1 : (MOTION_MICROSTEPS >> step_mode);
+}
+
+/**
+ * @brief Attaches a DRV8825 motor to an axis.
+ *
+ * The motor must already have been passed to DRV8825_Init(). The first
+ * call starts the motion task.
+ *
+ * @param axis  Axis to attach
+ * @param motor Motor driving that axis
+ */
+void MOTION_Register_Axis(MOTION_AXIS_t axis, DRV8825_t *motor);
+
+/**
+ * @brief Sets the function that tells the caller's task to run
+ *        MOTION_Service(), NULL for none.
+ */
+void MOTION_Set_Done_Hook(MOTION_HOOK_t hook);
+
+/**
+ * @brief Queues a move on an axis.
+ *
+ * The motion task starts it once everything queued before it on the same
+ * axis has finished and their callbacks have run.
+ *
+ * @param axis Axis to move
+ * @param cmd  Move to perform (copied)
+ * @return Handle for the move, or 0 if the axis queue is full
+ */
+MOTION_HANDLE_t MOTION_Enqueue(MOTION_AXIS_t axis, const MOTION_COMMAND_t *cmd);
+
+/**
+ * @brief Delivers finished moves: runs their callbacks and buffers their
+ *        events, in the calling task.
+ *
+ * A move aborted by a driver fault puts the system in ERROR and reports
+ * ERROR_DRV8825_FAULT with the axis and step; the motion task has already
+ * cancelled the rest of that axis' queue.
+ *
+ * Call this from the main loop. It never blocks.
+ */
+void MOTION_Service(void);
+
+/**
+ * @brief Pops the oldest completion event.
+ *
+ * Only moves queued without an on_complete callback produce events here.
+ *
+ * @param event Filled with the event if one is available
+ * @return true if an event was returned
+ */
+bool MOTION_Poll_Event(MOTION_EVENT_t *event);
+
+/**
+ * @brief Polls a queued move without blocking.
+ *
+ * @param handle Handle returned by MOTION_Enqueue()
+ * @param event  Optional output, filled when the status is MOTION_STATUS_DONE
+ * @return Current status of the move
+ */
+MOTION_STATUS_t MOTION_Get_Status(MOTION_HANDLE_t handle, MOTION_EVENT_t *event);
+
+/**
+ * @brief Returns the axis position in MOTION_MICROSTEPS units.
+ *
+ * Forward moves count up. Includes the steps already sent by the running
+ * move. Only meaningful once the axis has been zeroed with
+ * MOTION_Set_Position() (e.g. after homing).
+ *
+ * @param axis Axis to read
+ */
+int32_t MOTION_Get_Position(MOTION_AXIS_t axis);
+
+/**
+ * @brief Overwrites the axis position, e.g. to zero it at a home switch.
+ *
+ * Call only while the axis is idle. The indexer phase is kept: the driver
+ * does not move.
+ *
+ * @param axis     Axis to set
+ * @param position New position in MOTION_MICROSTEPS units
+ */
+void MOTION_Set_Position(MOTION_AXIS_t axis, int32_t position);
+
+/**
+ * @brief Returns true if the axis has no active or queued moves.
+ *
+ * Reads without the motion lock, so it is a snapshot; safe from ISRs and
+ * plant models.
+ *
+ * @param axis Axis to check
+ */
+bool MOTION_Axis_Idle(MOTION_AXIS_t axis);
+
+/**
+ * @brief Waits for one queued move to finish.
+ *
+ * Keeps servicing the scheduler (so other axes keep moving) and runs the
+ * DRV8825 idle hook while waiting.
+ *
+ * Prefer callbacks or MOTION_Get_Status() in the state machine; this is
+ * for setup code and the blocking MOVEMENT/REHYDRATION wrappers.
+ *
+ * If more than MOTION_HISTORY_SIZE moves finished before this one was
+ * seen, its outcome is gone: that is reported as a system error and
+ * returned as MOTION_RESULT_UNKNOWN, never as success.
+ *
+ * @param handle Handle returned by MOTION_Enqueue()
+ * @param event  Optional output: the completion event
+ * @return How the move ended
+ */
+MOTION_RESULT_t MOTION_Wait(MOTION_HANDLE_t handle, MOTION_EVENT_t *event);
+
+/**
+ * @brief Stops the active move on an axis and drops everything queued.
+ *
+ * Every dropped move is still reported with MOTION_RESULT_CANCELLED.
+ *
+ * @param axis Axis to stop
+ */
+void MOTION_Cancel_Axis(MOTION_AXIS_t axis);
+
+#endif // MOTION_H
@@ -0,0 +1,105 @@
+/**
+ * @file    MOTION_PROFILE.cpp
+ * @brief   Trapezoidal / S-curve step interval planner
+ *
+ * Simulates the acceleration ramp one step at a time: each step takes
+ * 1/v seconds, during which acceleration (and, for S-curves, jerk) is
+ * applied. The resulting periods are sampled into the plan's ramp table.
+ *
+ * Date:   Oct 2026
+ */
+
+#include <Arduino.h>
+#include "MOTION_PROFILE.h"
+
+/**
+ * @brief Advances the ramp simulation by one step.
+ *
+ * For S-curves the acceleration grows at max_jerk until the remaining
+ * speed gap is just enough to ramp it back down, so the axis arrives at
+ * cruise speed with (nearly) zero acceleration.
+ *
+ * @param v       Current speed (steps/s), updated in place
+ * @param a       Current acceleration (steps/s^2), updated in place
+ * @param profile Axis limits
+ */
+static void MOTION_PROFILE_Advance(float *v, float *a, const MOTION_PROFILE_t *profile)
+{
+    float dt = 1.0f / *v;
+
+    if (profile->max_jerk > 0)
+    {
+        float minAccel = profile->max_accel * MOTION_PROFILE_MIN_ACCEL_FRAC;
+        float speedToGo = profile->max_speed - *v;
+
+        if (speedToGo <= (*a * *a) / (2.0f * profile->max_jerk))
+            *a -= profile->max_jerk * dt; // Ease into cruise
+        else
+            *a += profile->max_jerk * dt; // Build up acceleration
+
+        if (*a > profile->max_accel)
+            *a = profile->max_accel;
+        if (*a < minAccel)
+            *a = minAccel;
+    }
+
+    *v += *a * dt;
+    if (*v > profile->max_speed)
+        *v = profile->max_speed;
+}
+
+/**
+ * @brief Builds the accelerated step interval table for one move.
+ */
+void MOTION_PROFILE_Plan(MOTION_PLAN_t *plan, uint32_t steps, const MOTION_PROFILE_t *profile)
+{
+    float startSpeed = profile->start_speed > 1.0f ? profile->start_speed : 1.0f;
+
+    // Axis cannot accelerate: run the whole move at the cruise (or start) speed
+    if (profile->max_accel <= 0 || profile->max_speed <= startSpeed)
+    {
+        float speed = profile->max_speed > startSpeed ? profile->max_speed : startSpeed;
+        MOTION_PROFILE_Constant(plan, steps, (uint32_t)(1000000.0f / speed));
+        return;
+    }
+
+    float initialAccel = profile->max_jerk > 0 ? 0.0f : profile->max_accel;
+
+    // Pass 1: count how many steps the ramp needs
+    float v = startSpeed;
+    float a = initialAccel;
+    uint32_t rampSteps = 0;
+    while (v < profile->max_speed && rampSteps < MOTION_PROFILE_MAX_RAMP_STEPS)
+    {
+        MOTION_PROFILE_Advance(&v, &a, profile);
+        rampSteps++;
+    }
+
+    plan->totalSteps = steps;
+    plan->rampSteps = rampSteps;
+    plan->stepsPerEntry = (rampSteps + MOTION_PROFILE_RAMP_SIZE - 1) / MOTION_PROFILE_RAMP_SIZE;
+    if (plan->stepsPerEntry == 0)
+        plan->stepsPerEntry = 1;
+    plan->cruiseInterval = (uint32_t)(1000000.0f / profile->max_speed);
+
+    // Pass 2: sample the step period at the start of every table entry
+    v = startSpeed;
+    a = initialAccel;
+    for (uint32_t step = 0; step < rampSteps; step++)
+    {
+        if (step % plan->stepsPerEntry == 0)
+            plan->ramp[step / plan->stepsPerEntry] = (uint32_t)(1000000.0f / v);
+        MOTION_PROFILE_Advance(&v, &a, profile);
+    }
+}
+
+/**
+ * @brief Builds a plan that runs every step at the same period.
+ */
+void MOTION_PROFILE_Constant(MOTION_PLAN_t *plan, uint32_t steps, uint32_t period_us)
+{
+    plan->totalSteps = steps;
+    plan->rampSteps = 0;
+    plan->stepsPerEntry = 1;
+    plan->cruiseInterval = period_us;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file    MOTION_PROFILE.h
+ * @brief   Acceleration planner for DRV8825 stepper moves
+ *
+ * Turns per-axis velocity, acceleration and jerk limits into a table of
+ * step intervals. The table is built once per move in task context (float
+ * math) and then read from the step timer ISR with integer math only, since
+ * the FPU must not be used inside an ESP32 interrupt.
+ *
+ * With max_jerk = 0 the ramp is trapezoidal (constant acceleration);
+ * otherwise the acceleration itself is ramped, giving an S-curve.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+#include <Arduino.h>
+
+// === Planner Limits ===
+#define MOTION_PROFILE_RAMP_SIZE      256      // Interval table entries per move
+#define MOTION_PROFILE_MAX_RAMP_STEPS 1000000  // Give up on ramps longer than this
+#define MOTION_PROFILE_MIN_ACCEL_FRAC 0.05f    // S-curve never lets accel drop below 5% of max
+
+/**
+ * @struct MOTION_PROFILE_t
+ * @brief  Kinematic limits for one axis, in steps of the active step mode.
+ */
+typedef struct
+{
+    float start_speed; ///< Speed the axis can start/stop at without a ramp (steps/s)
+    float max_speed;   ///< Cruise speed (steps/s)
+    float max_accel;   ///< Acceleration limit (steps/s^2)
+    float max_jerk;    ///< Jerk limit (steps/s^3), 0 = trapezoidal ramp
+} MOTION_PROFILE_t;
+
+/**
+ * @struct MOTION_PLAN_t
+ * @brief  Precomputed step intervals for one move.
+ *
+ * The acceleration ramp is stored once and mirrored for deceleration.
+ * Each table entry covers `stepsPerEntry` consecutive steps so long ramps
+ * still fit in MOTION_PROFILE_RAMP_SIZE entries.
+ */
+typedef struct
+{
+    uint32_t totalSteps;                        ///< Steps in the move
+    uint32_t rampSteps;                         ///< Steps needed to reach cruise speed
+    uint32_t stepsPerEntry;                     ///< Steps covered by each ramp entry
+    uint32_t cruiseInterval;                    ///< Step period at cruise speed (us)
+    uint32_t ramp[MOTION_PROFILE_RAMP_SIZE];    ///< Step periods during the ramp (us)
+} MOTION_PLAN_t;
+
+/**
+ * @brief Builds an accelerated plan for a move of `steps` steps.
+ *
+ * Short moves that cannot reach cruise speed get a triangular (or
+ * S-shaped) profile peaking in the middle of the move.
+ *
+ * @param plan    Plan to fill
+ * @param steps   Number of steps in the move
+ * @param profile Axis limits
+ */
+void MOTION_PROFILE_Plan(MOTION_PLAN_t *plan, uint32_t steps, const MOTION_PROFILE_t *profile);
+
+/**
+ * @brief Builds a constant-speed plan (no ramp).
+ *
+ * @param plan      Plan to fill
+ * @param steps     Number of steps in the move
+ * @param period_us Step period in microseconds
+ */
+void MOTION_PROFILE_Constant(MOTION_PLAN_t *plan, uint32_t steps, uint32_t period_us);
+
+/**
+ * @brief Returns the step period for step `step` of a plan (ISR safe).
+ *
+ * Integer-only so it can run inside the step timer interrupt.
+ *
+ * @param plan Plan built by MOTION_PROFILE_Plan() or MOTION_PROFILE_Constant()
+ * @param step Zero-based index of the step about to be sent
+ * @return Step period in microseconds
+ */
+static inline uint32_t IRAM_ATTR MOTION_PROFILE_Interval(const MOTION_PLAN_t *plan, uint32_t step)
+{
+    uint32_t fromEnd = plan->totalSteps - 1 - step;
+    uint32_t rampPos = (step < fromEnd) ? step : fromEnd; // Distance to nearest end of move
+    if (rampPos >= plan->rampSteps)
+        return plan->cruiseInterval;
+
+    uint32_t index = rampPos / plan->stepsPerEntry;
+    if (index >= MOTION_PROFILE_RAMP_SIZE)
+        index = MOTION_PROFILE_RAMP_SIZE - 1;
+    return plan->ramp[index];
+}
+
+#endif // MOTION_PROFILE_H
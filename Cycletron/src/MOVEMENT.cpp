@@ -12,6 +12,7 @@
 
 #include <Arduino.h>
 #include "MOVEMENT.h"
+#include "MOTION.h"
 #include "globals.h"
 #include "send_functions.h"
 
@@ -19,26 +20,43 @@
 // === Constants ===
 #define MOVEMENT_STEP_DELAY_US 1000 // Delay between microsteps
 #define MOVEMENT_MAX_STEPS 10000 // Set your safety threshold here // needs to be found and changed
+#define MOVEMENT_LOST_STEP_TOLERANCE 10 // Allowed bumper position mismatch before flagging lost steps (full steps)
 
 // === Global State ===
 volatile bool movementFrontTriggered = false;
 volatile bool movementBackTriggered = false;
 
 // === Motor and Sensor Config ===
-DRV8825_t movementMotor = {
-    .step_pin = 6,
-    .dir_pin = 7,
-    .fault_pin = 15,
-    .mode0_pin = 16,
-    .mode1_pin = 17,
-    .mode2_pin = 18,
-    .enable_pin = 8};
+// Pins are template arguments so the step ISR uses constant register masks
+typedef DRV8825<6, 7, 15, 16, 17, 18, 8> MovementDriver; // step, dir, fault, mode0, mode1, mode2, enable
+DRV8825_t movementMotor = MovementDriver::Config();
 
 BUMPER_t bumpers_m = {
     .front_bumper_pin = 3,
     .back_bumper_pin = 10,
 };
 
+// === Motion Profiles (full step) ===
+// Bumper-to-bumper travel (was a fixed 1000 us delay, ~1k steps/s)
+const MOTION_PROFILE_t movementProfile = {
+    .start_speed = 800,
+    .max_speed = 3000,
+    .max_accel = 6000,
+    .max_jerk = 60000};
+
+// Homing at startup: slower so the first bumper contact is gentle
+const MOTION_PROFILE_t movementHomingProfile = {
+    .start_speed = 600,
+    .max_speed = 1200,
+    .max_accel = 3000,
+    .max_jerk = 0};
+
+// === Carriage Position (full steps from the back bumper) ===
+// Vial loading and extraction run bumper to bumper; the first front bumper
+// hit after homing measures the travel for the lost-step check.
+static bool movementHomed = false;       // Position is valid (back bumper seen)
+static int32_t movementFrontPosition = 0; // Measured front bumper position, 0 = not seen yet
+
 enum MovementInitState {
   INIT_IDLE,
   INIT_MOVING_BACK,
@@ -47,6 +65,9 @@ enum MovementInitState {
 
 MovementInitState movementInitState = INIT_IDLE;
 
+static bool MOVEMENT_Run_To_Limit(int direction, const MOTION_PROFILE_t *profile);
+static void MOVEMENT_Set_Home();
+
 /**
  * @brief Initializes the movement motor and immediately disables it.
  *
@@ -56,7 +77,8 @@ MovementInitState movementInitState = INIT_IDLE;
  */
 void MOVEMENT_InitAndDisable()
 {
-  DRV8825_Init(&movementMotor);
+  MovementDriver::Init(&movementMotor);
+  MOTION_Register_Axis(MOTION_AXIS_CARRIAGE, &movementMotor);
   Serial.println("[MOVEMENT] Motor initialized and disabled.");
 }
 
@@ -71,7 +93,8 @@ void MOVEMENT_Init()
 {
     delay(500); // Delay for system stability
 
-    DRV8825_Init(&movementMotor); // Initialize motor driver
+    MovementDriver::Init(&movementMotor); // Initialize motor driver
+    MOTION_Register_Axis(MOTION_AXIS_CARRIAGE, &movementMotor);
     CheckBumpers();               // Read initial bumper state
 
     Serial.printf("Initial BUMPER_STATE: %d\n", BUMPER_STATE);
@@ -81,22 +104,21 @@ void MOVEMENT_Init()
     {
         Serial.println("[MOVEMENT] Back bumper already pressed. No movement required.");
         DRV8825_Disable(&movementMotor);
+        MOVEMENT_Set_Home();
     }
     else
     {
-        while (BUMPER_STATE != 2)
+        bool homed = MOVEMENT_Run_To_Limit(DRV8825_BACKWARD, &movementHomingProfile);
+        CheckBumpers(); // Consume the bumper flag
+        BUMPER_STATE = homed ? 2 : 0;
+        if (homed)
         {
-            DRV8825_Move(&movementMotor, 1, DRV8825_BACKWARD, MOVEMENT_STEP_DELAY_US);
-            CheckBumpers();
-            
-            // Yield control every few steps to prevent WebSocket timeouts during init
-            static int initStepCount = 0;
-            if (++initStepCount >= 10) {
-              initStepCount = 0;
-              yield(); // Allow WiFi/WebSocket processing
-            }
+            MOVEMENT_Set_Home();
+        }
+        else
+        {
+            Serial.println("[MOVEMENT] Homing failed: back bumper not reached.");
         }
-        DRV8825_Disable(&movementMotor);
     }
 
     Serial.println("[MOVEMENT] Initialization complete.");
@@ -145,51 +167,194 @@ int CheckBumpers()
 }
 
 /**
- * @brief Moves motor based on bumper state.
+ * @brief Zeroes the carriage position at the back bumper.
+ */
+static void MOVEMENT_Set_Home()
+{
+  MOTION_Set_Position(MOTION_AXIS_CARRIAGE, 0);
+  movementHomed = true;
+  Serial.println("[MOVEMENT] Homed: position = 0");
+}
+
+/**
+ * @brief Compares the counted position with a bumper that was just hit.
+ *
+ * The first front bumper hit after homing measures the travel; later hits
+ * must land within MOVEMENT_LOST_STEP_TOLERANCE of it. The position is
+ * re-synced to the bumper either way.
  *
- * If front bumper is pressed, move backward until back is pressed.
- * If back bumper is pressed, move forward until front is pressed.
- * Movement stops immediately if target bumper is hit.
- * Updated to yield control for WebSocket stability.
+ * @param direction Bumper that was hit (DRV8825_FORWARD = front)
+ * @return false if steps were lost
  */
-void MOVEMENT_Move_FORWARD()
+static bool MOVEMENT_Check_Bumper_Position(int direction)
 {
-  DRV8825_Set_Step_Mode(&movementMotor, DRV8825_FULL_STEP);
-  CheckBumpers();
-  int stepCount = 0;
-  while (BUMPER_STATE != 1)
+  if (!movementHomed)
   {
-    DRV8825_Move(&movementMotor, 1, DRV8825_FORWARD, MOVEMENT_STEP_DELAY_US);
-    CheckBumpers();
-    stepCount++;
-    if (stepCount > MOVEMENT_MAX_STEPS) {
-      MOVEMENT_Stop();
-      currentState = SystemState::ERROR;
-      sendSystemError(ERROR_MOVEMENT_MAX_STEPS_FORWARD);
-      return;
-    }
+    if (direction == DRV8825_BACKWARD)
+      MOVEMENT_Set_Home();
+    return true;
   }
-  MOVEMENT_Stop();
+
+  int32_t counted = MOVEMENT_Get_Position();
+  if (direction == DRV8825_FORWARD && movementFrontPosition == 0)
+  {
+    movementFrontPosition = counted;
+    Serial.printf("[MOVEMENT] Front bumper measured at %ld steps\n", (long)counted);
+    return true;
+  }
+
+  int32_t expected = (direction == DRV8825_FORWARD) ? movementFrontPosition : 0;
+  MOTION_Set_Position(MOTION_AXIS_CARRIAGE, expected * MOTION_Step_Size(DRV8825_FULL_STEP));
+  if (abs(counted - expected) > MOVEMENT_LOST_STEP_TOLERANCE)
+  {
+    Serial.printf("[MOVEMENT] Lost steps: counted %ld at %s bumper, expected %ld\n",
+                  (long)counted, direction == DRV8825_FORWARD ? "front" : "back", (long)expected);
+    return false;
+  }
+  return true;
 }
 
-void MOVEMENT_Move_BACKWARD()
+/**
+ * @brief Raises the lost-step error.
+ */
+static void MOVEMENT_Report_Lost_Steps()
 {
-  DRV8825_Set_Step_Mode(&movementMotor, DRV8825_FULL_STEP);
-  CheckBumpers();
-  int stepCount = 0;
-  while (BUMPER_STATE != 2)
-  {
-    DRV8825_Move(&movementMotor, 1, DRV8825_BACKWARD, MOVEMENT_STEP_DELAY_US);
-    CheckBumpers();
-    stepCount++;
-    if (stepCount > MOVEMENT_MAX_STEPS) {
-      MOVEMENT_Stop();
-      currentState = SystemState::ERROR;
-      sendSystemError(ERROR_MOVEMENT_MAX_STEPS_BACKWARD);
-      return;
+  setState(SystemState::ERROR);
+  sendSystemError(ERROR_MOVEMENT_LOST_STEPS);
+}
+
+/**
+ * @brief Queues a carriage move toward one bumper on the motion scheduler.
+ *
+ * The bumper ISR halts pulse generation directly, so there is no per-step
+ * polling and the step count at contact is exact.
+ *
+ * @param direction DRV8825_FORWARD (front bumper) or DRV8825_BACKWARD (back bumper)
+ * @param profile   Speed/acceleration limits for the move
+ * @param onComplete Optional completion callback (see MOTION_COMMAND_t)
+ * @param context   Passed to onComplete
+ * @return Motion handle, or 0 if the carriage queue is full
+ */
+static MOTION_HANDLE_t MOVEMENT_Queue_To_Limit(int direction, const MOTION_PROFILE_t *profile,
+                                               MOTION_CALLBACK_t onComplete = NULL, void *context = NULL)
+{
+  MOTION_COMMAND_t cmd = {
+      .type = MOTION_MOVE_UNTIL_LIMIT,
+      .steps = MOVEMENT_MAX_STEPS,
+      .direction = direction,
+      .step_mode = DRV8825_FULL_STEP,
+      .profile = profile,
+      .limit_pin = (direction == DRV8825_FORWARD) ? bumpers_m.front_bumper_pin : bumpers_m.back_bumper_pin,
+      .on_complete = onComplete,
+      .context = context,
+      .coarse_profile = NULL, // Already at full step
+      .approach_steps = 0};
+  return MOTION_Enqueue(MOTION_AXIS_CARRIAGE, &cmd);
+}
+
+/**
+ * @brief Runs the carriage toward one bumper and waits for it to get there.
+ *
+ * Other axes keep moving while this waits.
+ *
+ * @return true if the bumper was reached, false if MOVEMENT_MAX_STEPS ran out
+ */
+static bool MOVEMENT_Run_To_Limit(int direction, const MOTION_PROFILE_t *profile)
+{
+  MOTION_EVENT_t event;
+  MOTION_RESULT_t result = MOTION_Wait(MOVEMENT_Queue_To_Limit(direction, profile), &event);
+  bool hit = (result == MOTION_RESULT_LIMIT);
+  Serial.printf("[MOVEMENT] %s after %lu steps\n",
+                hit ? "Bumper reached" : "No bumper",
+                (unsigned long)event.steps);
+  return hit;
+}
+
+/**
+ * @brief Queues a forward move to the front bumper without waiting.
+ */
+MOTION_HANDLE_t MOVEMENT_Queue_FORWARD(MOTION_CALLBACK_t onComplete, void *context)
+{
+  return MOVEMENT_Queue_To_Limit(DRV8825_FORWARD, &movementProfile, onComplete, context);
+}
+
+/**
+ * @brief Queues a backward move to the back bumper without waiting.
+ */
+MOTION_HANDLE_t MOVEMENT_Queue_BACKWARD(MOTION_CALLBACK_t onComplete, void *context)
+{
+  return MOVEMENT_Queue_To_Limit(DRV8825_BACKWARD, &movementProfile, onComplete, context);
+}
+
+/**
+ * @brief Handles the end of a bumper-to-bumper move.
+ *
+ * Shared by the blocking moves and the completion callbacks in the state
+ * machine, so both report errors the same way.
+ */
+bool MOVEMENT_Finish_Move(const MOTION_EVENT_t *event, int direction)
+{
+  bool hit = (event->result == MOTION_RESULT_LIMIT);
+  Serial.printf("[MOVEMENT] %s after %lu steps\n",
+                hit ? "Bumper reached" : "No bumper",
+                (unsigned long)event->steps);
+  CheckBumpers(); // Consume the bumper flag
+  MOVEMENT_Stop();
+
+  if (hit) {
+    BUMPER_STATE = (direction == DRV8825_FORWARD) ? 1 : 2;
+    if (!MOVEMENT_Check_Bumper_Position(direction)) {
+      MOVEMENT_Report_Lost_Steps();
+      return false;
     }
+    return true;
   }
-  MOVEMENT_Stop();
+  if (event->result != MOTION_RESULT_CANCELLED && event->result != MOTION_RESULT_FAULT &&
+      event->result != MOTION_RESULT_UNKNOWN) {
+    setState(SystemState::ERROR);
+    sendSystemError(direction == DRV8825_FORWARD ? ERROR_MOVEMENT_MAX_STEPS_FORWARD
+                                                 : ERROR_MOVEMENT_MAX_STEPS_BACKWARD);
+  }
+  return false;
+}
+
+/**
+ * @brief Returns the carriage position in full steps from the back bumper.
+ */
+int32_t MOVEMENT_Get_Position()
+{
+  return MOTION_Get_Position(MOTION_AXIS_CARRIAGE) / MOTION_Step_Size(DRV8825_FULL_STEP);
+}
+
+/**
+ * @brief Returns true once the carriage position is valid.
+ */
+bool MOVEMENT_Is_Homed()
+{
+  return movementHomed;
+}
+
+/**
+ * @brief Moves the carriage forward until the front bumper is hit.
+ *
+ * Movement stops inside the bumper interrupt. Reports an error if the
+ * bumper is not reached within MOVEMENT_MAX_STEPS.
+ */
+void MOVEMENT_Move_FORWARD()
+{
+  MOTION_EVENT_t event;
+  MOTION_Wait(MOVEMENT_Queue_FORWARD(NULL, NULL), &event);
+  MOVEMENT_Finish_Move(&event, DRV8825_FORWARD);
+}
+
+/**
+ * @brief Moves the carriage backward until the back bumper is hit.
+ */
+void MOVEMENT_Move_BACKWARD()
+{
+  MOTION_EVENT_t event;
+  MOTION_Wait(MOVEMENT_Queue_BACKWARD(NULL, NULL), &event);
+  MOVEMENT_Finish_Move(&event, DRV8825_BACKWARD);
 }
 
 /**
@@ -197,30 +362,33 @@ void MOVEMENT_Move_BACKWARD()
  */
 void MOVEMENT_Stop()
 {
-  digitalWrite(movementMotor.step_pin, LOW);
-  DRV8825_Disable(&movementMotor);
+  DRV8825_Abort(&movementMotor);
   Serial.println("[MOVEMENT] Motor stopped.");
 }
 
 /**
  * @brief Interrupt handler for front bumper trigger.
  *
- * Sets the global movementFrontTriggered flag to true.
+ * Sets the global movementFrontTriggered flag to true and stops a
+ * forward move right here, without waiting for the main loop.
  * Keep minimal to avoid watchdog resets and WebSocket issues.
  */
 void IRAM_ATTR onMovementFrontLimit()
 {
+  DRV8825_Halt_From_ISR(&movementMotor, DRV8825_FORWARD);
   movementFrontTriggered = true;
 }
 
 /**
  * @brief Interrupt handler for back bumper trigger.
  *
- * Sets a flag indicating the back bumper has been triggered.
+ * Sets a flag indicating the back bumper has been triggered and stops
+ * a backward move right here.
  * Keep minimal to avoid watchdog resets and WebSocket issues.
  */
 void IRAM_ATTR onMovementBackLimit()
 {
+  DRV8825_Halt_From_ISR(&movementMotor, DRV8825_BACKWARD);
   movementBackTriggered = true;
 }
 
@@ -16,6 +16,7 @@
 
 #include <Arduino.h>
 #include "DRV8825.h"
+#include "MOTION.h"
 
 // === Global State Flag ===
 /**
@@ -93,17 +94,64 @@ void MOVEMENT_Move(void);
 
 
  /**
-  * @brief Moves motor based on bumper state.
+  * @brief Moves the carriage forward until the front bumper is pressed.
   *
-  * If front bumper is pressed, move backward until back is pressed.
-  * If back bumper is pressed, move forward until front is pressed.
-  * Movement stops immediately if target bumper is hit.
+  * Runs one continuous accelerated move; the front bumper interrupt stops
+  * the step pulses directly. Raises ERROR_MOVEMENT_MAX_STEPS_FORWARD if the
+  * bumper is not reached within MOVEMENT_MAX_STEPS.
   */
  void MOVEMENT_Move_FORWARD();
 
-
+ /**
+  * @brief Moves the carriage backward until the back bumper is pressed.
+  *
+  * Same as MOVEMENT_Move_FORWARD() in the other direction.
+  */
  void MOVEMENT_Move_BACKWARD();
 
+/**
+ * @brief Queues a move to the front bumper on the motion scheduler.
+ *
+ * Non-blocking counterpart of MOVEMENT_Move_FORWARD(). The callback should
+ * pass the event to MOVEMENT_Finish_Move().
+ *
+ * @param onComplete Completion callback, NULL = report via MOTION_Poll_Event()
+ * @param context    Passed to onComplete
+ * @return Motion handle, or 0 if the carriage queue is full
+ */
+MOTION_HANDLE_t MOVEMENT_Queue_FORWARD(MOTION_CALLBACK_t onComplete, void *context);
+
+/**
+ * @brief Queues a move to the back bumper on the motion scheduler.
+ *
+ * @param onComplete Completion callback, NULL = report via MOTION_Poll_Event()
+ * @param context    Passed to onComplete
+ * @return Motion handle, or 0 if the carriage queue is full
+ */
+MOTION_HANDLE_t MOVEMENT_Queue_BACKWARD(MOTION_CALLBACK_t onComplete, void *context);
+
+/**
+ * @brief Finishes a queued bumper move.
+ *
+ * Stops the motor, updates BUMPER_STATE and raises the max-steps error
+ * if the bumper was not reached. Cancelled moves are not errors.
+ *
+ * @param event     Completion event of the move
+ * @param direction DRV8825_FORWARD or DRV8825_BACKWARD
+ * @return true if the bumper was reached
+ */
+bool MOVEMENT_Finish_Move(const MOTION_EVENT_t *event, int direction);
+
+/**
+ * @brief Returns the carriage position in full steps from the back bumper.
+ */
+int32_t MOVEMENT_Get_Position(void);
+
+/**
+ * @brief Returns true once homing has given the carriage a valid position.
+ */
+bool MOVEMENT_Is_Homed(void);
+
 /**
  * @brief Immediately stops the motor.
  *
@@ -115,7 +163,7 @@ void MOVEMENT_Stop(void);
 /**
  * @brief Interrupt handler for front bumper trigger.
  *
- * Sets the global movementFrontTriggered flag to true.
+ * Halts a forward move and sets the global movementFrontTriggered flag.
  */
 
 void IRAM_ATTR onMovementFrontLimit();
@@ -123,7 +171,8 @@ void IRAM_ATTR onMovementFrontLimit();
 /**
  * @brief Interrupt handler for back bumper trigger.
  *
- * Sets a flag indicating the back bumper has been triggered.
+ * Halts a backward move and sets a flag indicating the back bumper has
+ * been triggered.
  */
 void IRAM_ATTR onMovementBackLimit();
 
@@ -0,0 +1,105 @@
+/**
+ * @file    PROTOTHREAD.h
+ * @brief   Stackless coroutines for multi-step operations
+ *
+ * A protothread is a function that runs until it has to wait for
+ * something, returns, and carries on from that point the next time it is
+ * called. A sequence such as "move out, wait for the user, move back" then
+ * reads as straight-line code, while the caller (a state's tick) never
+ * blocks. The ESP32 Arduino toolchain (GCC 8) has no C++20 coroutines, so
+ * this is the classic switch/__LINE__ construction: the only state kept
+ * between calls is the line to resume at.
+ *
+ * Rules inside PT_BEGIN() ... PT_END():
+ *   - locals do not survive a wait; keep state in statics or globals
+ *   - no switch statement may contain a wait
+ *   - at most one wait per source line
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef PROTOTHREAD_H
+#define PROTOTHREAD_H
+
+#include <stdint.h>
+
+/**
+ * @struct PT_t
+ * @brief  Where a protothread resumes; 0 = at the start.
+ */
+typedef struct
+{
+    uint16_t line;
+} PT_t;
+
+/**
+ * @brief What a protothread call returned.
+ */
+typedef enum
+{
+    PT_WAITING = 0, ///< Blocked in a wait; call again later
+    PT_EXITED,      ///< Gave up with PT_EXIT(); starts over on the next call
+    PT_ENDED        ///< Ran to PT_END(); starts over on the next call
+} PT_STATUS_t;
+
+/**
+ * @brief Makes the next call start from the beginning.
+ */
+#define PT_INIT(pt) ((pt)->line = 0)
+
+/**
+ * @brief True while the protothread is somewhere past its start.
+ */
+#define PT_IS_RUNNING(pt) ((pt)->line != 0)
+
+/**
+ * @brief Opens the body; pair with PT_END().
+ */
+#define PT_BEGIN(pt) \
+    switch ((pt)->line) \
+    { \
+    case 0:
+
+/**
+ * @brief Returns PT_WAITING until `condition` holds, checking it on every call.
+ */
+#define PT_WAIT_UNTIL(pt, condition) \
+    do \
+    { \
+        (pt)->line = __LINE__; \
+        [[fallthrough]]; \
+    case __LINE__: \
+        if (!(condition)) \
+            return PT_WAITING; \
+    } while (0)
+
+/**
+ * @brief Returns PT_WAITING once and resumes after it on the next call.
+ */
+#define PT_YIELD(pt) \
+    do \
+    { \
+        (pt)->line = __LINE__; \
+        return PT_WAITING; \
+    case __LINE__:; \
+    } while (0)
+
+/**
+ * @brief Abandons the sequence: returns PT_EXITED and starts over next time.
+ */
+#define PT_EXIT(pt) \
+    do \
+    { \
+        PT_INIT(pt); \
+        return PT_EXITED; \
+    } while (0)
+
+/**
+ * @brief Closes the body: returns PT_ENDED and starts over next time.
+ */
+#define PT_END(pt) \
+    } \
+    PT_INIT(pt); \
+    return PT_ENDED
+
+#endif // PROTOTHREAD_H
@@ -14,6 +14,7 @@
 #include "REHYDRATION.h"
 #include "MOVEMENT.h"
 #include "DRV8825.h"
+#include "MOTION.h"
 #include "globals.h"
 #include "send_functions.h"
 #include <math.h>
@@ -29,22 +30,71 @@ volatile bool rehydrationBackTriggered = false;
 int BUMPER_STATE = 0;
 
 // === Motor Configuration ===
-DRV8825_t rehydrationMotor = {
-    .step_pin = 1,
-    .dir_pin = 2,
-    .fault_pin = 42,
-    .mode0_pin = 41,
-    .mode1_pin = 40,
-    .mode2_pin = 39,
-    .enable_pin = 38};
+// Pins are template arguments so the step ISR uses constant register masks
+typedef DRV8825<1, 2, 42, 41, 40, 39, 38> RehydrationDriver; // step, dir, fault, mode0, mode1, mode2, enable
+DRV8825_t rehydrationMotor = RehydrationDriver::Config();
 
 BUMPER_t bumpers_r = {
     .front_bumper_pin = 46,
     .back_bumper_pin = 9,
 };
 
+// === Motion Profiles ===
+// Push runs at 1/16 step (was a fixed 50 us delay, ~18.5k steps/s)
+const MOTION_PROFILE_t syringePushProfile = {
+    .start_speed = 4000,
+    .max_speed = 24000,
+    .max_accel = 60000,
+    .max_jerk = 600000};
+
+// Pull runs at 1/16 step: the old 1/4-step figures x4, same plunger speed
+// (was a fixed 1000 us delay at 1/4 step, ~1k steps/s)
+const MOTION_PROFILE_t syringePullProfile = {
+    .start_speed = 3200,
+    .max_speed = 16000,
+    .max_accel = 32000,
+    .max_jerk = 320000};
+
+// Retract to the back bumper at 1/4 step (was a fixed 500 us delay, ~2k steps/s)
+const MOTION_PROFILE_t syringeRetractProfile = {
+    .start_speed = 1500,
+    .max_speed = 4000,
+    .max_accel = 8000,
+    .max_jerk = 80000};
+
+// Calibration stroke at 1/16 step (was a fixed 500 us delay, ~2k steps/s)
+const MOTION_PROFILE_t syringeCalibrationProfile = {
+    .start_speed = 2000,
+    .max_speed = 8000,
+    .max_accel = 20000,
+    .max_jerk = 200000};
+
+// Coarse travel at full step for long retracts (1.5x the 1/4-step retract speed,
+// at a quarter of the interrupts); the final approach runs in the move's own mode.
+// Push and pull keep their own plunger speed for the whole volume, so they don't use it.
+const MOTION_PROFILE_t syringeTravelProfile = {
+    .start_speed = 250,
+    .max_speed = 1500,
+    .max_accel = 3000,
+    .max_jerk = 30000};
+
+// Full steps left for the fine approach (1/2 rev, 0.025" of plunger travel)
+#define REHYDRATION_APPROACH_FULL_STEPS 100
+
+// Safety caps for moves that should end at a bumper (2x the full stroke)
+#define REHYDRATION_RETRACT_MAX_STEPS (MAX_SYRINGE_STEPS / 2)     // 1/4 steps
+#define REHYDRATION_CALIBRATION_MAX_STEPS (MAX_SYRINGE_STEPS * 2) // 1/16 steps
 
 
+
+/**
+ * @brief Fine approach length in the given step mode.
+ */
+static int Rehydration_Approach_Steps(int stepMode)
+{
+    return REHYDRATION_APPROACH_FULL_STEPS * (MOTION_Step_Size(DRV8825_FULL_STEP) / MOTION_Step_Size(stepMode));
+}
+
 /**
  * @brief Calculates how many microliters are moved per motor step.
  *
@@ -79,7 +129,8 @@ float calculate_uL_per_step(float syringeDiameterInches)
  */
 void Rehydration_InitAndDisable()
 {
-    DRV8825_Init(&rehydrationMotor);
+    RehydrationDriver::Init(&rehydrationMotor);
+    MOTION_Register_Axis(MOTION_AXIS_SYRINGE, &rehydrationMotor);
     Serial.println("[REHYDRATION] Motor initialized and disabled.");
 }
 
@@ -97,7 +148,8 @@ void Rehydration_Init(float syringeDiameterInches)
 {
     float syringeDiameterMM = syringeDiameterInches * 25.4f;
 
-    DRV8825_Init(&rehydrationMotor);
+    RehydrationDriver::Init(&rehydrationMotor);
+    MOTION_Register_Axis(MOTION_AXIS_SYRINGE, &rehydrationMotor);
     DRV8825_Set_Step_Mode(&rehydrationMotor, DRV8825_SIXTEENTH_STEP);
 
     float uL_per_step = calculate_uL_per_step(syringeDiameterInches);
@@ -110,16 +162,21 @@ void Rehydration_Init(float syringeDiameterInches)
 
 
 /**
- * @brief Dispenses fluid by pushing the syringe plunger forward.
+ * @brief Queues a dispense on the motion scheduler without waiting.
  *
- * Converts microliters into steps and sends a movement command.
+ * Converts microliters into steps, checks the syringe range and queues the
+ * push. The caller adds the steps from the completion event to
+ * syringeStepCount via Rehydration_Finish_Push().
  *
  * @param uL Volume to dispense in microliters
  * @param syringeDiameterInches Syringe diameter in inches
+ * @param onComplete Optional completion callback
+ * @param context Passed to onComplete
+ * @return Motion handle, or 0 if the push was refused
  */
-void Rehydration_Push(uint32_t uL, float syringeDiameterInches)
+MOTION_HANDLE_t Rehydration_Queue_Push(uint32_t uL, float syringeDiameterInches,
+                                       MOTION_CALLBACK_t onComplete, void *context)
 {
-    DRV8825_Set_Step_Mode(&rehydrationMotor, DRV8825_SIXTEENTH_STEP);
     uL = uL * 0.909; //Scale factor to calibrate syringe pump
     float uL_per_step = calculate_uL_per_step(syringeDiameterInches);
     uint32_t steps = (uint32_t)(uL / uL_per_step);
@@ -128,14 +185,50 @@ void Rehydration_Push(uint32_t uL, float syringeDiameterInches)
     extern int syringeStepCount;
     if (syringeStepCount + (int)steps > MAX_SYRINGE_STEPS) {
         Serial.println("[ERROR] Syringe step count would exceed safe range! Aborting push.");
-        currentState = SystemState::ERROR;
+        setState(SystemState::ERROR);
         sendSystemError(ERROR_SYRINGE_MAX_STEPS);
-        return;
+        return 0;
     }
 
     Serial.printf("[REHYDRATION] Pushing %lu uL (%lu steps)\n", uL, steps);
-    DRV8825_Move(&rehydrationMotor, steps, DRV8825_FORWARD, 50); // Push plunger
-    syringeStepCount += steps;
+    MOTION_COMMAND_t cmd = {
+        .type = MOTION_MOVE_STEPS,
+        .steps = (int)steps,
+        .direction = DRV8825_FORWARD,
+        .step_mode = DRV8825_SIXTEENTH_STEP,
+        .profile = &syringePushProfile,
+        .limit_pin = bumpers_r.front_bumper_pin,
+        .on_complete = onComplete,
+        .context = context,
+        .coarse_profile = NULL, // Full steps would be no faster than this profile
+        .approach_steps = 0};
+    return MOTION_Enqueue(MOTION_AXIS_SYRINGE, &cmd);
+}
+
+/**
+ * @brief Books the steps of a finished dispense.
+ */
+void Rehydration_Finish_Push(const MOTION_EVENT_t *event)
+{
+    syringeStepCount += event->steps; // Exact even if the front bumper stopped it
+}
+
+/**
+ * @brief Dispenses fluid by pushing the syringe plunger forward.
+ *
+ * Converts microliters into steps and sends a movement command.
+ *
+ * @param uL Volume to dispense in microliters
+ * @param syringeDiameterInches Syringe diameter in inches
+ */
+void Rehydration_Push(uint32_t uL, float syringeDiameterInches)
+{
+    MOTION_HANDLE_t handle = Rehydration_Queue_Push(uL, syringeDiameterInches, NULL, NULL);
+    if (handle == 0) return;
+
+    MOTION_EVENT_t event;
+    MOTION_Wait(handle, &event);
+    Rehydration_Finish_Push(&event);
 }
 
 /**
@@ -148,8 +241,6 @@ void Rehydration_Push(uint32_t uL, float syringeDiameterInches)
  */
 void Rehydration_Pull(uint32_t uL, float syringeDiameterInches)
 {
-    DRV8825_Set_Step_Mode(&rehydrationMotor, DRV8825_QUARTER_STEP); // More control
-
     float uL_per_step = calculate_uL_per_step(syringeDiameterInches);
     uint32_t steps = (uint32_t)(uL / uL_per_step);
 
@@ -157,14 +248,26 @@ void Rehydration_Pull(uint32_t uL, float syringeDiameterInches)
     extern int syringeStepCount;
     if (syringeStepCount - (int)steps < 0) {
         Serial.println("[ERROR] Syringe step count would go negative! Aborting pull.");
-        currentState = SystemState::ERROR;
+        setState(SystemState::ERROR);
         sendSystemError(ERROR_SYRINGE_MAX_STEPS);
         return;
     }
 
     Serial.printf("[REHYDRATION] Retracting %lu uL (%lu steps)\n", uL, steps);
-    DRV8825_Move(&rehydrationMotor, steps, DRV8825_BACKWARD, DRV8825_DEFAULT_STEP_DELAY_US);
-    syringeStepCount -= steps;
+    MOTION_COMMAND_t cmd = {
+        .type = MOTION_MOVE_STEPS,
+        .steps = (int)steps,
+        .direction = DRV8825_BACKWARD,
+        .step_mode = DRV8825_SIXTEENTH_STEP, // Same units as syringeStepCount
+        .profile = &syringePullProfile,
+        .limit_pin = bumpers_r.back_bumper_pin,
+        .on_complete = NULL,
+        .context = NULL,
+        .coarse_profile = NULL, // Full steps would change the draw rate
+        .approach_steps = 0};
+    MOTION_EVENT_t event;
+    MOTION_Wait(MOTION_Enqueue(MOTION_AXIS_SYRINGE, &cmd), &event);
+    syringeStepCount -= event.steps;
 }
 
 /**
@@ -183,20 +286,24 @@ void Rehydration_Stop()
 /**
  * @brief Interrupt handler for front bumper trigger.
  *
- * Sets a flag indicating the front bumper has been triggered.
+ * Halts a forward (push) move and sets a flag indicating the front
+ * bumper has been triggered.
  * Keep this minimal to avoid watchdog resets.
  */
 void IRAM_ATTR onRehydrationFrontLimit() {
+    DRV8825_Halt_From_ISR(&rehydrationMotor, DRV8825_FORWARD);
     rehydrationFrontTriggered = true;
 }
 
 /**
  * @brief Interrupt handler for back bumper trigger.
  *
- * Sets a flag indicating the back bumper has been triggered.
+ * Halts a backward (retract) move and sets a flag indicating the back
+ * bumper has been triggered.
  * Keep this minimal to avoid watchdog resets.
  */
 void IRAM_ATTR onRehydrationBackLimit() {
+    DRV8825_Halt_From_ISR(&rehydrationMotor, DRV8825_BACKWARD);
     rehydrationBackTriggered = true;
 }
 
@@ -236,26 +343,109 @@ void REHYDRATION_HandleInterrupts() {
 }
 
 /**
- * @brief Continuously moves the syringe backward until the back bumper is triggered.
+ * @brief Queues a syringe move toward one bumper on the motion scheduler.
+ *
+ * The bumper ISR halts pulse generation directly, so the step count at
+ * contact is exact and there is no per-step enable/poll overhead.
  *
- * This uses a while-loop to move indefinitely in the BACKWARD direction
- * until the back limit switch is hit (rehydrationBackTriggered becomes true).
- * Be sure REHYDRATION_ConfigureInterrupts() has been called before using.
+ * @param direction DRV8825_FORWARD (front bumper) or DRV8825_BACKWARD (back bumper)
+ * @param maxSteps  Safety cap on the move
+ * @param stepMode  DRV8825 microstep mode for the move
+ * @param profile   Speed/acceleration limits for the move
+ * @param travelSteps Expected distance to the bumper (stepMode units), 0 if unknown.
+ *                  When known, all but the approach runs at full step.
+ * @param onComplete Optional completion callback
+ * @param context   Passed to onComplete
+ * @return Motion handle, or 0 if the syringe queue is full
  */
-void Rehydration_BackUntilBumper() {
-    DRV8825_Set_Step_Mode(&rehydrationMotor, DRV8825_QUARTER_STEP); // precise and slower
-    R_CheckBumpers();
+static MOTION_HANDLE_t Rehydration_Queue_To_Limit(int direction, int maxSteps, int stepMode, const MOTION_PROFILE_t *profile,
+                                                  int travelSteps = 0, MOTION_CALLBACK_t onComplete = NULL, void *context = NULL)
+{
+    // Coarse travel stops one approach short of the expected bumper position
+    int approach = Rehydration_Approach_Steps(stepMode);
+    bool adaptive = (travelSteps > approach && travelSteps - approach < maxSteps);
+
+    MOTION_COMMAND_t cmd = {
+        .type = MOTION_MOVE_UNTIL_LIMIT,
+        .steps = maxSteps,
+        .direction = direction,
+        .step_mode = stepMode,
+        .profile = profile,
+        .limit_pin = (direction == DRV8825_FORWARD) ? bumpers_r.front_bumper_pin : bumpers_r.back_bumper_pin,
+        .on_complete = onComplete,
+        .context = context,
+        .coarse_profile = adaptive ? &syringeTravelProfile : NULL,
+        .approach_steps = adaptive ? maxSteps - (travelSteps - approach) : 0};
+    return MOTION_Enqueue(MOTION_AXIS_SYRINGE, &cmd);
+}
+
+/**
+ * @brief Runs the syringe toward one bumper and waits for it to get there.
+ *
+ * @param stepsDone Optional output: steps sent before the move ended
+ * @return true if the bumper was reached
+ */
+static bool Rehydration_Run_To_Limit(int direction, int maxSteps, int stepMode, const MOTION_PROFILE_t *profile,
+                                     int travelSteps, uint32_t *stepsDone)
+{
+    MOTION_EVENT_t event;
+    MOTION_RESULT_t result = MOTION_Wait(Rehydration_Queue_To_Limit(direction, maxSteps, stepMode, profile, travelSteps), &event);
+    if (stepsDone)
+        *stepsDone = event.steps;
+    bool hit = (result == MOTION_RESULT_LIMIT);
+
+    R_CheckBumpers(); // Consume the bumper flag
+    BUMPER_STATE = hit ? (direction == DRV8825_FORWARD ? 1 : 2) : 0;
+    return hit;
+}
 
+/**
+ * @brief Queues a full retract to the back bumper without waiting.
+ *
+ * syringeStepCount (1/16 steps) says how far the bumper is, so the stroke
+ * runs at full step and only the last stretch at 1/4 step.
+ */
+MOTION_HANDLE_t Rehydration_Queue_BackUntilBumper(MOTION_CALLBACK_t onComplete, void *context)
+{
     Serial.println("[REHYDRATION] Moving backward until bumper is triggered...");
+    int travel = syringeStepCount / (MOTION_Step_Size(DRV8825_QUARTER_STEP) / MOTION_Step_Size(DRV8825_SIXTEENTH_STEP));
+    return Rehydration_Queue_To_Limit(DRV8825_BACKWARD, REHYDRATION_RETRACT_MAX_STEPS, DRV8825_QUARTER_STEP,
+                                      &syringeRetractProfile, travel, onComplete, context);
+}
 
-      while (BUMPER_STATE != 2){
-        DRV8825_Move(&rehydrationMotor, 1, DRV8825_BACKWARD, 500); // one step at a time
-        R_CheckBumpers();
+/**
+ * @brief Handles the end of a retract to the back bumper.
+ */
+bool Rehydration_Finish_Retract(const MOTION_EVENT_t *event)
+{
+    bool hit = (event->result == MOTION_RESULT_LIMIT);
+    R_CheckBumpers(); // Consume the bumper flag
+    BUMPER_STATE = hit ? 2 : 0;
+    Rehydration_Stop();
 
+    if (hit) {
+        Serial.println("[REHYDRATION] Back bumper triggered — motion stopped.");
+        return true;
+    }
+    if (event->result != MOTION_RESULT_CANCELLED && event->result != MOTION_RESULT_FAULT &&
+        event->result != MOTION_RESULT_UNKNOWN) {
+        Serial.println("[ERROR] Back bumper not reached during retract.");
+        setState(SystemState::ERROR);
+        sendSystemError(ERROR_SYRINGE_MAX_STEPS);
     }
+    return false;
+}
 
-    Rehydration_Stop();
-    Serial.println("[REHYDRATION] Back bumper triggered — motion stopped.");
+/**
+ * @brief Continuously moves the syringe backward until the back bumper is triggered.
+ *
+ * Runs a single accelerated move that the back bumper interrupt stops
+ * directly. Be sure REHYDRATION_ConfigureInterrupts() has been called before using.
+ */
+void Rehydration_BackUntilBumper() {
+    MOTION_EVENT_t event;
+    MOTION_Wait(Rehydration_Queue_BackUntilBumper(NULL, NULL), &event);
+    Rehydration_Finish_Retract(&event);
 }
 
 
@@ -315,32 +505,17 @@ uint32_t Rehydration_CalibrationTest() {
     
     // First move back until bumper
     Serial.println("[CALIBRATION] Moving to back bumper...");
-    DRV8825_Set_Step_Mode(&rehydrationMotor, DRV8825_QUARTER_STEP);
-    R_CheckBumpers();
-    while (BUMPER_STATE != 2) {
-        DRV8825_Move(&rehydrationMotor, 1, DRV8825_BACKWARD, 500);
-        R_CheckBumpers();
-        yield(); // Allow WebSocket processing
-    }
+    Rehydration_Run_To_Limit(DRV8825_BACKWARD, REHYDRATION_RETRACT_MAX_STEPS, DRV8825_QUARTER_STEP, &syringeRetractProfile,
+                             syringeStepCount / 4, NULL); // 1/16 -> 1/4 steps
     
-    // Switch to 1/16th stepping for precise measurement
-    DRV8825_Set_Step_Mode(&rehydrationMotor, DRV8825_SIXTEENTH_STEP);
     delay(100); // Short pause between direction changes
     
-    // Move forward counting steps until front bumper
+    // Move forward counting steps until front bumper (counted by the step engine).
+    // The whole stroke runs at 1/16th: the real stroke is what is being measured,
+    // so a full-step segment sized from the nominal one could reach the bumper.
     Serial.println("[CALIBRATION] Counting steps to front bumper...");
-    R_CheckBumpers();
-    while (BUMPER_STATE != 1) {
-        DRV8825_Move(&rehydrationMotor, 1, DRV8825_FORWARD, 500);
-        stepCount++;
-        R_CheckBumpers();
-        
-        // Progress update every 1000 steps
-        if (stepCount % 1000 == 0) {
-            Serial.printf("[CALIBRATION] Steps so far: %lu\n", stepCount);
-            yield(); // Allow WebSocket processing
-        }
-    }
+    Rehydration_Run_To_Limit(DRV8825_FORWARD, REHYDRATION_CALIBRATION_MAX_STEPS, DRV8825_SIXTEENTH_STEP, &syringeCalibrationProfile,
+                             0, &stepCount);
     
     Serial.printf("[CALIBRATION] Total steps (1/16th): %lu\n", stepCount);
     Serial.printf("[CALIBRATION] Approximate full steps: %lu\n", stepCount/16);
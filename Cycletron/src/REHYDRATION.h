@@ -18,6 +18,7 @@
 
 #include <Arduino.h>
 #include "DRV8825.h"
+#include "MOTION.h"
 
 // === Global State Flag ===
 /**
@@ -88,6 +89,29 @@ void Rehydration_Init(float syringeDiameterInches);
  */
 void Rehydration_Push(uint32_t uL, float syringeDiameterInches);
 
+/**
+ * @brief Queues a dispense on the motion scheduler and returns immediately.
+ *
+ * Same conversion and range check as Rehydration_Push(). The callback
+ * should pass the event to Rehydration_Finish_Push() so syringeStepCount
+ * gets the steps actually sent.
+ *
+ * @param uL Volume of fluid to dispense, in microliters.
+ * @param syringeDiameterInches Syringe diameter in inches
+ * @param onComplete Completion callback, NULL = report via MOTION_Poll_Event()
+ * @param context Passed to onComplete
+ * @return Motion handle, or 0 if the push was refused
+ */
+MOTION_HANDLE_t Rehydration_Queue_Push(uint32_t uL, float syringeDiameterInches,
+                                       MOTION_CALLBACK_t onComplete, void *context);
+
+/**
+ * @brief Adds the steps of a finished dispense to syringeStepCount.
+ *
+ * @param event Completion event of a move queued by Rehydration_Queue_Push()
+ */
+void Rehydration_Finish_Push(const MOTION_EVENT_t *event);
+
 /**
  * @brief Retracts the syringe plunger to draw fluid or prime the system.
  *
@@ -147,6 +171,26 @@ void REHYDRATION_HandleInterrupts();
  */
 void Rehydration_BackUntilBumper();
 
+/**
+ * @brief Queues a retract to the back bumper and returns immediately.
+ *
+ * @param onComplete Completion callback, NULL = report via MOTION_Poll_Event()
+ * @param context Passed to onComplete
+ * @return Motion handle, or 0 if the syringe queue is full
+ */
+MOTION_HANDLE_t Rehydration_Queue_BackUntilBumper(MOTION_CALLBACK_t onComplete, void *context);
+
+/**
+ * @brief Finishes a retract queued by Rehydration_Queue_BackUntilBumper().
+ *
+ * Disables the motor and raises ERROR_SYRINGE_MAX_STEPS if the back bumper
+ * was not reached. Cancelled moves are not errors.
+ *
+ * @param event Completion event of the retract
+ * @return true if the back bumper was reached
+ */
+bool Rehydration_Finish_Retract(const MOTION_EVENT_t *event);
+
 
 int R_CheckBumpers();
 
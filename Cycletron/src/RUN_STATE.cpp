@@ -0,0 +1,90 @@
+/**
+ * @file    RUN_STATE.cpp
+ * @brief   Consistent snapshots of the run state for other tasks
+ *
+ * Publishing bumps the sequence to odd (readers switch to copy 1), rewrites
+ * copy 0, bumps it to even (readers switch back) and rewrites copy 1. A
+ * reader copies whichever one the sequence points at and checks that the
+ * sequence did not move meanwhile. Unlike a single-copy seqlock, a reader
+ * that preempts the writer on the same core still finds a stable copy
+ * instead of spinning on a write that cannot finish.
+ *
+ * Date:   Oct 2026
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include "RUN_STATE.h"
+
+static RUN_STATE_t copies[2];
+static std::atomic<uint32_t> sequence(0);
+static TaskHandle_t writer = NULL;
+
+/**
+ * @brief Gathers the globals into one snapshot.
+ */
+static void RUN_STATE_Capture(RUN_STATE_t *run)
+{
+    run->state = currentState;
+    run->previousState = previousState;
+
+    run->volumeAddedPerCycle = volumeAddedPerCycle;
+    run->syringeDiameter = syringeDiameter;
+    run->desiredHeatingTemperature = desiredHeatingTemperature;
+    run->durationOfHeating = durationOfHeating;
+    run->durationOfMixing = durationOfMixing;
+    run->numberOfCycles = numberOfCycles;
+    for (int i = 0; i < 3; i++)
+        run->sampleZones[i] = sampleZonesArray[i];
+    run->sampleZoneCount = sampleZoneCount;
+
+    run->syringeStepCount = syringeStepCount;
+    run->heatingStartTime = heatingStartTime;
+    run->mixingStartTime = mixingStartTime;
+    run->heatingStarted = heatingStarted;
+    run->mixingStarted = mixingStarted;
+    run->refillingStarted = refillingStarted;
+    run->completedCycles = completedCycles;
+    run->currentCycle = currentCycle;
+    run->heatingProgressPercent = heatingProgressPercent;
+    run->mixingProgressPercent = mixingProgressPercent;
+    run->heatingDurationRemaining = heatingDurationRemaining;
+    run->mixingDurationRemaining = mixingDurationRemaining;
+}
+
+void RUN_STATE_Init(void)
+{
+    writer = xTaskGetCurrentTaskHandle();
+    RUN_STATE_Publish();
+}
+
+void RUN_STATE_Publish(void)
+{
+    RUN_STATE_t run;
+    RUN_STATE_Capture(&run);
+
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release); // Copy 1 from the last publish is complete first
+    sequence.store(seq + 1, std::memory_order_relaxed); // Readers use copy 1
+    std::atomic_thread_fence(std::memory_order_release);
+    copies[0] = run;
+    sequence.store(seq + 2, std::memory_order_release); // Readers use copy 0
+    copies[1] = run;
+}
+
+void RUN_STATE_Read(RUN_STATE_t *snapshot)
+{
+    if (xTaskGetCurrentTaskHandle() == writer)
+    {
+        // The globals are ours; make sure the snapshot has our latest changes
+        RUN_STATE_Publish();
+    }
+
+    uint32_t seq;
+    do
+    {
+        seq = sequence.load(std::memory_order_acquire);
+        *snapshot = copies[seq & 1];
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (sequence.load(std::memory_order_relaxed) != seq);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file    RUN_STATE.h
+ * @brief   Consistent snapshots of the run state for other tasks
+ *
+ * The run state (state machine, parameters, cycle progress) lives in the
+ * globals of globals.cpp and is only written by the control task (the
+ * Arduino loop). RUN_STATE_Publish() copies it into a two-copy seqlock:
+ * the sequence number says which copy is stable, so a reader never waits
+ * for the writer, and the writer never waits for a reader. A reader only
+ * retries if a whole publish finished while it was copying.
+ *
+ * Telemetry and recovery serializers read a RUN_STATE_t instead of the
+ * globals, so a packet never mixes fields from two moments of the run.
+ *
+ * For now this is groundwork: every serializer runs in the control task,
+ * so each read simply republishes. It is the interface for moving a
+ * reader (e.g. telemetry in the comms task) off the control task.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifndef RUN_STATE_H
+#define RUN_STATE_H
+
+#include <Arduino.h>
+#include "globals.h"
+
+/**
+ * @struct RUN_STATE_t
+ * @brief  One snapshot of the run.
+ */
+typedef struct
+{
+    SystemState state;          ///< currentState
+    SystemState previousState;  ///< State to resume after a pause
+
+    // Parameters from the frontend or recovery
+    float volumeAddedPerCycle;
+    float syringeDiameter;
+    float desiredHeatingTemperature;
+    float durationOfHeating;
+    float durationOfMixing;
+    int numberOfCycles;
+    int sampleZones[3];
+    int sampleZoneCount;
+
+    // Progress
+    int syringeStepCount;
+    unsigned long heatingStartTime;
+    unsigned long mixingStartTime;
+    bool heatingStarted;
+    bool mixingStarted;
+    bool refillingStarted;
+    int completedCycles;
+    int currentCycle;
+    float heatingProgressPercent;
+    float mixingProgressPercent;
+    float heatingDurationRemaining;
+    float mixingDurationRemaining;
+} RUN_STATE_t;
+
+/**
+ * @brief Makes the calling task the writer and publishes the first snapshot.
+ *
+ * Call once from setup(), right after FSM_Init() and before anything can
+ * change state or other tasks read.
+ */
+void RUN_STATE_Init(void);
+
+/**
+ * @brief Copies the globals into the snapshot; control task only.
+ *
+ * Never blocks. Cheap enough to call on every loop() pass.
+ */
+void RUN_STATE_Publish(void);
+
+/**
+ * @brief Takes the latest snapshot; any task, never takes a lock.
+ *
+ * From the control task it publishes first, so the snapshot includes the
+ * caller's own changes.
+ *
+ * @param snapshot Filled with the run state
+ */
+void RUN_STATE_Read(RUN_STATE_t *snapshot);
+
+#endif // RUN_STATE_H
@@ -0,0 +1,378 @@
+/**
+ * @file    SIMULATOR.cpp
+ * @brief   Accelerated full-run simulator: replays an experiment on virtual time
+ *
+ * Runs the unmodified firmware (main.cpp setup()/loop()) on the simulated
+ * board from lib/SimHAL and plays the frontend's part over the WebSocket:
+ * vial setup, one parameters packet, start. When the firmware reports the
+ * end of the run it prints where the time went:
+ *
+ *   - time in each state from startCycle to ENDED, total and per cycle
+ *   - carriage and syringe motion time
+ *   - heater ramp time (HEATING entry to thermistor at setpoint) and duty
+ *   - control quality after the ramp: peak overshoot and mean |error|
+ *   - cycles/hour
+ *
+ * A multi-hour experiment takes seconds of host time, so scheduling and
+ * control changes can be compared run against run.
+ *
+ * Build and run:
+ *   pio run -e native_sim && .pio/build/native_sim/program [options]
+ *
+ * Options:
+ *   --parameters=FILE  parameters packet to replay: the first line holding
+ *                      {"type":"parameters",...} (a frontend log such as
+ *                      ExamplePackets.txt works). Default: simDefaultParameters
+ *   --cycles=N         override numberOfCycles from the packet
+ *   --autotune         run the heater autotune (at the packet's setpoint)
+ *                      before starting, and report its result
+ *   --max-hours=N      give up after N virtual hours (default 72)
+ *   --verbose          echo the firmware's Serial output
+ *
+ * Exits non-zero if the run errors or does not finish in time.
+ *
+ * Date:   Oct 2026
+ */
+
+#ifdef CYCLETRON_SIMULATOR
+
+#include <Arduino.h>
+#include <time.h>
+#include "globals.h"
+#include "MOTION.h"
+#include "MOVEMENT.h"
+#include "HEATING.h"
+#include "FSM.h"
+#include "SIM_HAL.h"
+#include "SIM_BOARD.h"
+
+#define SIM_RUN_TICK_US 1000               // Observer period
+#define SIM_RUN_TICK_MS (SIM_RUN_TICK_US / 1000)
+#define SIM_RUN_STATE_COUNT ((int)SystemState::ERROR + 1)
+#define SIM_RUN_PACKET_MAX 1024
+#define SIM_RUN_RAMP_BAND 0.5f             // "At setpoint" = within this of it (C)
+
+// Frontend-format packet (numbers as strings, zones as numbers)
+static const char simDefaultParameters[] =
+    "{\"type\":\"parameters\",\"data\":{\"volumeAddedPerCycle\":\"50\",\"durationOfRehydration\":\"20\","
+    "\"syringeDiameter\":\"0.5\",\"desiredHeatingTemperature\":\"60\",\"durationOfHeating\":\"600\","
+    "\"sampleZonesToMix\":[1,2,3],\"durationOfMixing\":\"120\",\"numberOfCycles\":\"10\"}}";
+
+static const char *const simStateNames[SIM_RUN_STATE_COUNT] = {
+    "VIAL_SETUP", "WAITING", "IDLE", "READY", "REHYDRATING", "HEATING", "MIXING",
+    "REFILLING", "EXTRACTING", "LOGGING", "PAUSED", "ENDED", "AUTOTUNING", "ERROR"};
+
+/**
+ * @brief What the simulated frontend is waiting for.
+ */
+typedef enum
+{
+    SIM_RUN_BOOT,         ///< Homing in setup(); then vialSetup yes
+    SIM_RUN_VIAL_LOAD,    ///< Carriage out for loading; then vialSetup continue
+    SIM_RUN_VIAL_RETURN,  ///< Carriage home (WAITING); then parameters
+    SIM_RUN_PARAMETERS,   ///< READY; then autotune on (--autotune) or startCycle on
+    SIM_RUN_AUTOTUNE,     ///< Back in READY after AUTOTUNING; then startCycle on
+    SIM_RUN_CYCLING,      ///< Measuring until ENDED
+    SIM_RUN_DONE
+} SIM_RUN_PHASE_t;
+
+static struct
+{
+    SIM_RUN_PHASE_t phase;
+    char parameters[SIM_RUN_PACKET_MAX];
+    int cyclesOverride;      ///< 0 = use the packet
+    bool autotune;           ///< Tune the heater before starting
+    bool autotuneSeen;       ///< AUTOTUNING state entered
+    uint64_t autotuneStartMs;
+    uint64_t autotuneMs;
+    uint64_t deadlineMs;
+
+    uint64_t setupMs;        ///< Power-up to startCycle
+    uint64_t runMs;          ///< startCycle to ENDED
+    uint64_t stateMs[SIM_RUN_STATE_COUNT];
+    uint32_t stateEntries[SIM_RUN_STATE_COUNT];
+    uint64_t motionMs[MOTION_AXIS_COUNT];
+    double heaterOnMs;       ///< Heater energy as full-power milliseconds
+
+    bool finished;           ///< ENDED or ERROR entered
+    SystemState finalState;
+    int cycles;              ///< HEATING -> REHYDRATING transitions
+    bool ramping;            ///< In HEATING, setpoint not reached yet
+    uint64_t rampMs;         ///< Current ramp so far
+    uint64_t rampTotalMs;
+    uint64_t rampMaxMs;
+    int rampsDone;
+    int rampsMissed;         ///< HEATING left before reaching setpoint
+    float overshootMax;      ///< Highest sensor temperature above setpoint (C)
+    double holdErrorSum;     ///< Sum of |sensor - setpoint| after the ramp, per tick
+    uint64_t holdTicks;
+} simRun;
+
+/**
+ * @brief Reads the parameters packet from a frontend log or packet file.
+ */
+static bool SIM_Run_Load_Parameters(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+        return false;
+
+    char line[SIM_RUN_PACKET_MAX];
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), file))
+    {
+        if (!strstr(line, "\"type\":\"parameters\""))
+            continue;
+        char *start = strchr(line, '{');
+        line[strcspn(line, "\r\n")] = '\0';
+        snprintf(simRun.parameters, sizeof(simRun.parameters), "%s", start);
+        found = true;
+    }
+    fclose(file);
+    return found;
+}
+
+/**
+ * @brief Simulated frontend: sends the next packet once the firmware is ready.
+ */
+static void SIM_Run_Drive(void)
+{
+    switch (simRun.phase)
+    {
+    case SIM_RUN_BOOT:
+        if (currentState == SystemState::IDLE && MOVEMENT_Is_Homed())
+        {
+            SIM_WebSocket_Receive("{\"type\":\"button\",\"name\":\"vialSetup\",\"state\":\"yes\"}");
+            simRun.phase = SIM_RUN_VIAL_LOAD;
+        }
+        break;
+
+    case SIM_RUN_VIAL_LOAD:
+        if (currentState == SystemState::VIAL_SETUP && movementForwardDone)
+        {
+            SIM_WebSocket_Receive("{\"type\":\"button\",\"name\":\"vialSetup\",\"state\":\"continue\"}");
+            simRun.phase = SIM_RUN_VIAL_RETURN;
+        }
+        break;
+
+    case SIM_RUN_VIAL_RETURN:
+        if (currentState == SystemState::WAITING)
+        {
+            SIM_WebSocket_Receive(simRun.parameters);
+            simRun.phase = SIM_RUN_PARAMETERS;
+        }
+        break;
+
+    case SIM_RUN_PARAMETERS:
+        if (currentState == SystemState::READY && simRun.autotune)
+        {
+            SIM_WebSocket_Receive("{\"type\":\"button\",\"name\":\"autotune\",\"state\":\"on\"}");
+            simRun.autotuneStartMs = SIM_Now_Ns() / 1000000ULL;
+            simRun.phase = SIM_RUN_AUTOTUNE;
+            break;
+        }
+        // fall through
+    case SIM_RUN_AUTOTUNE:
+        if (currentState == SystemState::AUTOTUNING)
+            simRun.autotuneSeen = true;
+        if (simRun.phase == SIM_RUN_AUTOTUNE && !simRun.autotuneSeen)
+            break;
+        if (currentState == SystemState::READY)
+        {
+            if (simRun.phase == SIM_RUN_AUTOTUNE)
+                simRun.autotuneMs = SIM_Now_Ns() / 1000000ULL - simRun.autotuneStartMs;
+            if (simRun.cyclesOverride > 0)
+                numberOfCycles = simRun.cyclesOverride;
+            SIM_WebSocket_Receive("{\"type\":\"button\",\"name\":\"startCycle\",\"state\":\"on\"}");
+            simRun.setupMs = SIM_Now_Ns() / 1000000ULL;
+            simRun.stateEntries[(int)currentState]++;
+            simRun.phase = SIM_RUN_CYCLING;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief FSM observer: books every transition, including states left in
+ *        the same pass (ENDED) that a tick would never sample.
+ */
+static void SIM_Run_Transition(SystemState from, SystemState to)
+{
+    if (!simRun.finished && (to == SystemState::ENDED || to == SystemState::ERROR))
+    {
+        simRun.finished = true;
+        simRun.finalState = to;
+    }
+    if (simRun.phase != SIM_RUN_CYCLING)
+        return;
+
+    if (from == SystemState::HEATING && simRun.ramping)
+    {
+        simRun.rampsMissed++;
+        simRun.ramping = false;
+    }
+    if (from == SystemState::HEATING && to == SystemState::REHYDRATING)
+        simRun.cycles++;
+    if (to == SystemState::HEATING)
+    {
+        simRun.ramping = true;
+        simRun.rampMs = 0;
+    }
+    simRun.stateEntries[(int)to]++;
+}
+
+/**
+ * @brief Books one tick of the measured run.
+ */
+static void SIM_Run_Measure(void)
+{
+    SystemState state = currentState;
+    simRun.runMs += SIM_RUN_TICK_MS;
+    simRun.stateMs[(int)state] += SIM_RUN_TICK_MS;
+    for (int axis = 0; axis < MOTION_AXIS_COUNT; axis++)
+    {
+        if (!MOTION_Axis_Idle((MOTION_AXIS_t)axis))
+            simRun.motionMs[axis] += SIM_RUN_TICK_MS;
+    }
+    simRun.heaterOnMs += SIM_Get_Pin_Duty(HEATING_GPIO) * SIM_RUN_TICK_MS;
+
+    if (simRun.ramping)
+    {
+        simRun.rampMs += SIM_RUN_TICK_MS;
+        if (SIM_THERMAL_Sensor_C() >= desiredHeatingTemperature - SIM_RUN_RAMP_BAND)
+        {
+            simRun.ramping = false;
+            simRun.rampsDone++;
+            simRun.rampTotalMs += simRun.rampMs;
+            if (simRun.rampMs > simRun.rampMaxMs)
+                simRun.rampMaxMs = simRun.rampMs;
+        }
+    }
+    else if (state == SystemState::HEATING)
+    {
+        float error = SIM_THERMAL_Sensor_C() - desiredHeatingTemperature;
+        if (error > simRun.overshootMax)
+            simRun.overshootMax = error;
+        simRun.holdErrorSum += fabs(error);
+        simRun.holdTicks++;
+    }
+}
+
+static double SIM_Run_Host_Seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double simHostStart = 0;
+
+/**
+ * @brief Prints the run summary.
+ */
+static void SIM_Run_Report(bool completed)
+{
+    double runS = simRun.runMs / 1000.0;
+    double hours = runS / 3600.0;
+
+    printf("\n[SIM] %s: %d/%d cycles, %.1f s virtual (%.2f h) after %.1f s setup, %.2f s host\n",
+           completed ? "Run complete" : "Run INCOMPLETE", simRun.cycles, numberOfCycles, runS, hours,
+           simRun.setupMs / 1000.0, SIM_Run_Host_Seconds() - simHostStart);
+    printf("[SIM] Parameters: %.1f uL/cycle, %.2f in syringe, %.1f C for %.0f s, mix %.0f s, %d zone(s)\n",
+           volumeAddedPerCycle, syringeDiameter, desiredHeatingTemperature, durationOfHeating,
+           durationOfMixing, sampleZoneCount);
+
+    if (simRun.autotune)
+    {
+        const HEATING_AUTOTUNE_t *tune = HEATING_Autotune_Get();
+        printf("[SIM] Autotune: %s in %.1f s, Ku %.2f Tu %.1f s -> Kp %.3f Ki %.4f Kd %.2f\n",
+               tune->status == HEATING_AUTOTUNE_DONE ? "done" : "FAILED", simRun.autotuneMs / 1000.0,
+               tune->ku, tune->tu, tune->pid.kp, tune->pid.ki, tune->pid.kd);
+    }
+    printf("%-12s %10s %7s %8s %12s\n", "state", "total s", "share", "entries", "per cycle s");
+    for (int i = 0; i < SIM_RUN_STATE_COUNT; i++)
+    {
+        if (simRun.stateMs[i] == 0 && simRun.stateEntries[i] == 0)
+            continue;
+        double s = simRun.stateMs[i] / 1000.0;
+        printf("%-12s %10.1f %6.1f%% %8lu %12.1f\n", simStateNames[i], s, runS > 0 ? 100.0 * s / runS : 0.0,
+               (unsigned long)simRun.stateEntries[i], simRun.cycles ? s / simRun.cycles : 0.0);
+    }
+
+    printf("[SIM] Motion: carriage %.1f s, syringe %.1f s\n",
+           simRun.motionMs[MOTION_AXIS_CARRIAGE] / 1000.0, simRun.motionMs[MOTION_AXIS_SYRINGE] / 1000.0);
+    printf("[SIM] Heater ramp: mean %.1f s, max %.1f s over %d ramp(s), %d never reached setpoint; on %.1f%% of run\n",
+           simRun.rampsDone ? simRun.rampTotalMs / 1000.0 / simRun.rampsDone : 0.0, simRun.rampMaxMs / 1000.0,
+           simRun.rampsDone, simRun.rampsMissed, runS > 0 ? 100.0 * simRun.heaterOnMs / simRun.runMs : 0.0);
+    printf("[SIM] Hold: overshoot %.2f C, mean |error| %.2f C\n", simRun.overshootMax,
+           simRun.holdTicks ? simRun.holdErrorSum / simRun.holdTicks : 0.0);
+    printf("[SIM] Throughput: %.2f cycles/hour\n", hours > 0 ? simRun.cycles / hours : 0.0);
+}
+
+/**
+ * @brief Observer tick (foreground, every SIM_RUN_TICK_US of virtual time).
+ */
+static void SIM_Run_Tick(uint64_t nowNs, void *context)
+{
+    (void)context;
+    if (simRun.phase == SIM_RUN_DONE)
+        return;
+
+    SIM_Run_Drive();
+    if (simRun.phase == SIM_RUN_CYCLING)
+        SIM_Run_Measure();
+
+    if (simRun.finished)
+    {
+        bool completed = (simRun.finalState == SystemState::ENDED) && simRun.phase == SIM_RUN_CYCLING;
+        SIM_Run_Report(completed);
+        simRun.phase = SIM_RUN_DONE;
+        SIM_Finish(completed ? 0 : 1);
+    }
+    else if (nowNs / 1000000ULL >= simRun.deadlineMs)
+    {
+        printf("\n[SIM] Timed out in state %s\n", simStateNames[(int)currentState]);
+        SIM_Run_Report(false);
+        simRun.phase = SIM_RUN_DONE;
+        SIM_Finish(1);
+    }
+}
+
+void SIM_Harness_Init(int argc, char **argv)
+{
+    bool verbose = false;
+    uint32_t maxHours = 72;
+
+    snprintf(simRun.parameters, sizeof(simRun.parameters), "%s", simDefaultParameters);
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--parameters=", 13) == 0)
+        {
+            if (!SIM_Run_Load_Parameters(argv[i] + 13))
+            {
+                printf("[SIM] No parameters packet in %s\n", argv[i] + 13);
+                SIM_Finish(2);
+            }
+        }
+        else if (strncmp(argv[i], "--cycles=", 9) == 0)
+            simRun.cyclesOverride = atoi(argv[i] + 9);
+        else if (strncmp(argv[i], "--max-hours=", 12) == 0)
+            maxHours = (uint32_t)strtoul(argv[i] + 12, NULL, 10);
+        else if (strcmp(argv[i], "--autotune") == 0)
+            simRun.autotune = true;
+        else if (strcmp(argv[i], "--verbose") == 0)
+            verbose = true;
+    }
+
+    simRun.deadlineMs = (uint64_t)maxHours * 3600ULL * 1000ULL;
+    SIM_Set_Serial_Echo(verbose);
+    SIM_Add_Periodic(SIM_Run_Tick, NULL, SIM_RUN_TICK_US);
+    FSM_Set_Observer(SIM_Run_Transition);
+    simHostStart = SIM_Run_Host_Seconds();
+    printf("[SIM] Replaying: %s\n", simRun.parameters);
+}
+
+#endif // CYCLETRON_SIMULATOR
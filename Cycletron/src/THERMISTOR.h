@@ -0,0 +1,144 @@
+/**
+ * @file    THERMISTOR.h
+ * @brief   Divider voltage to temperature, through a compile-time table
+ *
+ * The table maps the thermistor divider output in mV straight to
+ * temperature, so a reading costs two loads and an integer interpolation
+ * instead of a division and a log(). It is generated by the compiler from
+ * the divider constants below, with either model:
+ *
+ *   BETA            1/T = 1/T0 + ln(R/R0) / BETA (default)
+ *   STEINHART_HART  1/T = A + B ln(R) + C ln(R)^3, coefficients from
+ *                   THERMISTOR_SH_A/B/C (defaults reproduce the BETA curve;
+ *                   replace them with a three-point calibration fit)
+ *
+ * Entries are every THERMISTOR_LUT_STEP_MV in hundredths of a °C; inputs are
+ * rounded to 1/256 mV and interpolated linearly.
+ *
+ * Date:   Oct 2026
+ */
+
+ #ifndef THERMISTOR_H
+ #define THERMISTOR_H
+
+ #include <stdint.h>
+
+ // === Model ===
+ #define THERMISTOR_MODEL_BETA 0
+ #define THERMISTOR_MODEL_STEINHART_HART 1
+ #ifndef THERMISTOR_MODEL
+ #define THERMISTOR_MODEL THERMISTOR_MODEL_BETA
+ #endif
+
+ // === Divider and Thermistor ===
+ constexpr double THERMISTOR_VREF = 3.28;      // Divider supply (V)
+ constexpr double THERMISTOR_R0 = 100000.0;    // Resistance at 25°C (reference temp)
+ constexpr double THERMISTOR_R1 = 4630.0;      // Fixed resistor to ground
+ constexpr double THERMISTOR_BETA = 3850.0;    // Beta value of thermistor
+ constexpr double THERMISTOR_T0 = 298.15;      // Reference temp in Kelvin (25°C)
+
+ // === Table ===
+ #define THERMISTOR_LUT_STEP_SHIFT 3           // 8 mV between entries
+ #define THERMISTOR_LUT_STEP_MV (1 << THERMISTOR_LUT_STEP_SHIFT)
+ #define THERMISTOR_LUT_FRAC_BITS 8            // Fixed-point input: 1/256 mV
+ #define THERMISTOR_LUT_SHIFT (THERMISTOR_LUT_STEP_SHIFT + THERMISTOR_LUT_FRAC_BITS)
+ #define THERMISTOR_LUT_SIZE ((int)(THERMISTOR_VREF * 1000) / THERMISTOR_LUT_STEP_MV + 2)
+ #define THERMISTOR_LUT_MIN_CENTI -32768       // Open sensor (0 mV)
+ #define THERMISTOR_LUT_MAX_CENTI 32767        // Shorted sensor (VREF)
+
+ /**
+  * @brief Natural log usable in constant expressions (range reduction to
+  *        [1, 2), then the atanh series; double precision).
+  */
+ constexpr double THERMISTOR_Ln(double x) {
+   double k = 0;
+   while (x >= 2) { x /= 2; k += 1; }
+   while (x < 1) { x *= 2; k -= 1; }
+   double y = (x - 1) / (x + 1);
+   double y2 = y * y;
+   double term = y, sum = 0;
+   for (int n = 1; n < 40; n += 2) {
+     sum += term / n;
+     term *= y2;
+   }
+   return k * 0.69314718055994530942 + 2 * sum;
+ }
+
+ #if THERMISTOR_MODEL == THERMISTOR_MODEL_STEINHART_HART
+ #ifdef THERMISTOR_SH_A
+ constexpr double THERMISTOR_A = THERMISTOR_SH_A;
+ constexpr double THERMISTOR_B = THERMISTOR_SH_B;
+ constexpr double THERMISTOR_C = THERMISTOR_SH_C;
+ #else
+ constexpr double THERMISTOR_A = 1.0 / THERMISTOR_T0 - THERMISTOR_Ln(THERMISTOR_R0) / THERMISTOR_BETA;
+ constexpr double THERMISTOR_B = 1.0 / THERMISTOR_BETA;
+ constexpr double THERMISTOR_C = 0.0;
+ #endif
+ #endif
+
+ /**
+  * @brief Exact model: thermistor resistance (Ohms) to °C.
+  */
+ constexpr double THERMISTOR_Ohms_To_C(double ohms) {
+ #if THERMISTOR_MODEL == THERMISTOR_MODEL_STEINHART_HART
+   double l = THERMISTOR_Ln(ohms);
+   return 1.0 / (THERMISTOR_A + THERMISTOR_B * l + THERMISTOR_C * l * l * l) - 273.15;
+ #else
+   return 1.0 / (1.0 / THERMISTOR_T0 + THERMISTOR_Ln(ohms / THERMISTOR_R0) / THERMISTOR_BETA) - 273.15;
+ #endif
+ }
+
+ /**
+  * @brief Divider output (mV) to thermistor resistance (Ohms), 0 if shorted.
+  */
+ constexpr double THERMISTOR_MV_To_Ohms(double mv) {
+   return (mv >= THERMISTOR_VREF * 1000) ? 0 : THERMISTOR_R1 * (THERMISTOR_VREF * 1000 - mv) / mv;
+ }
+
+ /**
+  * @struct THERMISTOR_LUT_t
+  * @brief  Temperature in hundredths of a °C every THERMISTOR_LUT_STEP_MV.
+  */
+ typedef struct {
+   int16_t centiC[THERMISTOR_LUT_SIZE];
+ } THERMISTOR_LUT_t;
+
+ /**
+  * @brief Builds the table (compile time only).
+  */
+ constexpr THERMISTOR_LUT_t THERMISTOR_Make_LUT() {
+   THERMISTOR_LUT_t lut{};
+   for (int i = 0; i < THERMISTOR_LUT_SIZE; i++) {
+     double ohms = (i == 0) ? 0 : THERMISTOR_MV_To_Ohms(i * THERMISTOR_LUT_STEP_MV);
+     double centi = (i == 0) ? THERMISTOR_LUT_MIN_CENTI
+                    : (ohms <= 0) ? THERMISTOR_LUT_MAX_CENTI
+                    : THERMISTOR_Ohms_To_C(ohms) * 100;
+     if (centi < THERMISTOR_LUT_MIN_CENTI) centi = THERMISTOR_LUT_MIN_CENTI;
+     if (centi > THERMISTOR_LUT_MAX_CENTI) centi = THERMISTOR_LUT_MAX_CENTI;
+     lut.centiC[i] = (int16_t)(centi < 0 ? centi - 0.5 : centi + 0.5);
+   }
+   return lut;
+ }
+
+ inline constexpr THERMISTOR_LUT_t thermistorLut = THERMISTOR_Make_LUT();
+
+ /**
+  * @brief Divider output to temperature through the table.
+  *
+  * @param mv Divider output in mV (clamped to 0..VREF)
+  * @return Temperature in °C; -327.68 for an open sensor, 327.67 if shorted
+  */
+ static inline float THERMISTOR_MV_To_C(float mv) {
+   if (mv <= 0) return thermistorLut.centiC[0] / 100.0f;
+
+   uint32_t q = (uint32_t)(mv * (1 << THERMISTOR_LUT_FRAC_BITS) + 0.5f);
+   uint32_t i = q >> THERMISTOR_LUT_SHIFT;
+   if (i >= THERMISTOR_LUT_SIZE - 1) return thermistorLut.centiC[THERMISTOR_LUT_SIZE - 1] / 100.0f;
+
+   int32_t f = (int32_t)(q & ((1UL << THERMISTOR_LUT_SHIFT) - 1));
+   int32_t low = thermistorLut.centiC[i];
+   int32_t high = thermistorLut.centiC[i + 1];
+   return (low + (((high - low) * f) >> THERMISTOR_LUT_SHIFT)) / 100.0f;
+ }
+
+ #endif // THERMISTOR_H
@@ -4,7 +4,7 @@
 SystemState currentState = SystemState::IDLE;
 SystemState previousState = SystemState::IDLE;
 
-// WebSocket client
+// WebSocket client (used only by the comms task, see COMMS.h)
 WebSocketsClient webSocket;
 
 
@@ -34,7 +34,6 @@ float mixingProgressPercent = 0;
 bool shouldMoveForward = false;
 bool shouldMoveBack = false;
 bool movementForwardDone = false;
-bool movementBackDone = false;
 
 // Duration tracking
 float heatingDurationRemaining = 0;
@@ -19,6 +19,7 @@ enum class SystemState
   LOGGING,
   PAUSED,
   ENDED,
+  AUTOTUNING,
   ERROR
 };
 
@@ -56,10 +57,9 @@ extern float heatingProgressPercent;
 extern float mixingProgressPercent;
 
 //flags used for back-and-forth movement in both vial setup and extraction
-extern bool shouldMoveForward; // Flag for back-and-forth movement
-extern bool shouldMoveBack; // Flag for back-and-forth movement
-extern bool movementForwardDone;
-extern bool movementBackDone;
+extern bool shouldMoveForward; // Request to move the carriage out; the carriage sequence consumes it
+extern bool shouldMoveBack; // Request to bring the carriage home; the carriage sequence consumes it
+extern bool movementForwardDone; // Carriage is out, waiting for the user
 
 // Add these to the extern declarations
 extern float heatingDurationRemaining;
@@ -70,6 +70,9 @@ typedef enum {
     ERROR_MOVEMENT_MAX_STEPS_BACKWARD,
     ERROR_SYRINGE_MAX_STEPS, // Add this for syringe overstep errors
     ERROR_DRV8825_FAULT, // Add this for DRV8825 fault pin error
+    ERROR_MOVEMENT_LOST_STEPS, // Bumper hit where the step count says it should not be
+    ERROR_MOTION_RESULT_LOST, // A move finished but its result was overwritten before it was read
+    ERROR_STATE_TABLE, // FSM_Init() rejected the state table; nothing runs
     // Add more error types as needed
 } SystemErrorType;
 
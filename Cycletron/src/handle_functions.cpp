@@ -3,6 +3,7 @@
 #include "send_functions.h"
 #include "handle_functions.h"
 #include "globals.h"
+#include "HEATING.h"
 
 /**
  * @brief Converts a command string to its corresponding CommandType enum.
@@ -31,6 +32,8 @@ CommandType parseCommand(const String &name)
         return CommandType::LOG_CYCLE;
     if (name == "restartESP32")
         return CommandType::RESTART_ESP32;
+    if (name == "autotune")
+        return CommandType::AUTOTUNE;
     return CommandType::UNKNOWN;
 }
 
@@ -155,6 +158,28 @@ void handleStateCommand(const String &name, const String &state)
             ESP.restart();
         }
         break;
+    case CommandType::AUTOTUNE:
+        if (state == "on")
+        {
+            // Only between runs, with the vials loaded so the load is tuned too
+            if (currentState != SystemState::WAITING && currentState != SystemState::READY)
+            {
+                Serial.println("[AUTOTUNE] Ignored: only available in WAITING or READY");
+                break;
+            }
+            float target = (desiredHeatingTemperature > 0) ? desiredHeatingTemperature : HEATING_AUTOTUNE_DEFAULT_C;
+            if (!HEATING_Autotune_Start(target))
+            {
+                Serial.printf("[AUTOTUNE] Setpoint %.1f C out of range\n", target);
+                break;
+            }
+            setState(SystemState::AUTOTUNING);
+        }
+        else if (currentState == SystemState::AUTOTUNING)
+        {
+            HEATING_Autotune_Cancel(); // tickAutotuning() reports it and returns to the previous state
+        }
+        break;
 
     case CommandType::UNKNOWN:
     default:
@@ -176,22 +201,21 @@ void handleRecoveryPacket(const JsonObject &data)
     if (!data["currentState"].is<const char *>() || !data["parameters"].is<JsonObject>())
     {
         Serial.println("Recovery packet is empty or invalid. Transitioning to IDLE state.");
-        currentState = SystemState::IDLE;
+        setState(SystemState::IDLE);
         return;
     }
 
     // Restore the last known operational state
     String recoveredState = data["currentState"].as<String>();
+    SystemState recovered = SystemState::IDLE;
     if (recoveredState == "HEATING")
-        currentState = SystemState::HEATING;
+        recovered = SystemState::HEATING;
     else if (recoveredState == "REHYDRATING")
-        currentState = SystemState::REHYDRATING;
+        recovered = SystemState::REHYDRATING;
     else if (recoveredState == "MIXING")
-        currentState = SystemState::MIXING;
+        recovered = SystemState::MIXING;
     else if (recoveredState == "READY")
-        currentState = SystemState::READY;
-    else
-        currentState = SystemState::IDLE;
+        recovered = SystemState::READY;
 
     // Restore parameters
     JsonObject parameters = data["parameters"];
@@ -237,6 +261,60 @@ void handleRecoveryPacket(const JsonObject &data)
     Serial.printf("  Syringe Step Count: %d\n", syringeStepCount);
     Serial.printf("  HeatingStarted: %s | HeatingStartTime: %lu\n", heatingStarted ? "true" : "false", heatingProgressPercent);
     Serial.printf("  MixingStarted: %s | MixingStartTime: %lu\n", mixingStarted ? "true" : "false", mixingProgressPercent);
+
+    // Enter the recovered state once its parameters are in place
+    setState(recovered);
+}
+
+/**
+ * @brief Reads an optional numeric parameter sent as a string or a number.
+ *
+ * @return false if the key is absent (value is left unchanged)
+ */
+static bool readOptionalFloat(const JsonObject &parameters, const char *key, float *value)
+{
+    if (parameters[key].is<const char *>())
+        *value = atof(parameters[key].as<const char *>());
+    else if (parameters[key].is<float>())
+        *value = parameters[key].as<float>();
+    else
+        return false;
+    return true;
+}
+
+/**
+ * @brief Applies the optional heater controller settings of a parameters packet.
+ *
+ * Keys: heatingMode ("pid" / "bangbang"), heatingKp, heatingKi, heatingKd,
+ * heatingSampleMs, heatingRampRate (°C/s). Absent keys keep their values,
+ * and so does an unknown heatingMode.
+ */
+static void applyHeatingParameters(const JsonObject &parameters)
+{
+    if (parameters["heatingMode"].is<const char *>())
+    {
+        String mode = parameters["heatingMode"].as<String>();
+        if (mode == "pid")
+            HEATING_Set_Mode(HEATING_MODE_PID);
+        else if (mode == "bangbang")
+            HEATING_Set_Mode(HEATING_MODE_BANG_BANG);
+        else
+            Serial.printf("[PARAMETERS] Unknown heatingMode '%s', keeping the current mode\n", mode.c_str());
+    }
+
+    HEATING_PID_t pid = *HEATING_Get_PID();
+    float sampleMs = (float)pid.sample_ms;
+    bool changed = false;
+    changed |= readOptionalFloat(parameters, "heatingKp", &pid.kp);
+    changed |= readOptionalFloat(parameters, "heatingKi", &pid.ki);
+    changed |= readOptionalFloat(parameters, "heatingKd", &pid.kd);
+    changed |= readOptionalFloat(parameters, "heatingSampleMs", &sampleMs);
+    changed |= readOptionalFloat(parameters, "heatingRampRate", &pid.ramp_rate);
+    if (changed)
+    {
+        pid.sample_ms = (uint32_t)sampleMs;
+        HEATING_Set_PID(&pid);
+    }
 }
 
 /**
@@ -276,6 +354,8 @@ void handleParametersPacket(const JsonObject &parameters)
         }
     }
 
+    applyHeatingParameters(parameters);
+
     // Print configuration summary
     Serial.println("[PARAMETERS] Parameters received and parsed.");
     Serial.printf("  Volume per cycle: %.2f µL\n", volumeAddedPerCycle);
@@ -283,6 +363,10 @@ void handleParametersPacket(const JsonObject &parameters)
     Serial.printf("  Heating temp: %.2f °C for %.2f s\n", desiredHeatingTemperature, durationOfHeating);
     Serial.printf("  Mixing duration: %.2f s with %d zone(s)\n", durationOfMixing, sampleZoneCount);
     Serial.printf("  Number of cycles: %d\n", numberOfCycles);
+    Serial.printf("  Heater: %s, Kp %.3f Ki %.4f Kd %.3f, %lu ms, ramp %.2f C/s\n",
+                  HEATING_Get_Mode() == HEATING_MODE_PID ? "PID" : "bang-bang",
+                  HEATING_Get_PID()->kp, HEATING_Get_PID()->ki, HEATING_Get_PID()->kd,
+                  (unsigned long)HEATING_Get_PID()->sample_ms, HEATING_Get_PID()->ramp_rate);
 
     // Ready the system for operation
     setState(SystemState::READY);
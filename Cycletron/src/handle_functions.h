@@ -16,6 +16,7 @@ enum class CommandType {
     REFILL,           ///< Command to refill the syringe
     LOG_CYCLE,        ///< Command to enter data logging mode
     RESTART_ESP32,    ///< Command to restart the ESP32
+    AUTOTUNE,         ///< Command to start/stop the heater autotune
     UNKNOWN           ///< Fallback for unrecognized commands
 };
 
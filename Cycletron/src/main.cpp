@@ -4,15 +4,23 @@
 #include "MIXING.h"
 #include "REHYDRATION.h"
 #include "MOVEMENT.h"
+#include "MOTION.h"
+#include "COMMS.h"
+#include "RUN_STATE.h"
+#include "FSM.h"
+#include "PROTOTHREAD.h"
 #include "globals.h"
 #include "send_functions.h"
 #include "handle_functions.h" 
-#include "state_websocket.h"  // Add this include to access onWebSocketEvent
+#include "state_websocket.h"  // onWebSocketMessage()
 
 #include <stdlib.h> // for atof()
 
 // TESTS
+// Builds with their own setup()/loop() (bench, simulator) define CYCLETRON_ALT_MAIN
+#ifndef CYCLETRON_ALT_MAIN
 #define TESTING_MAIN
+#endif
 
 #define Serial0 Serial
 #define ServerIP "10.0.0.30"
@@ -37,292 +45,592 @@ const char *password = "guessthepassword";
 
 unsigned long lastSent = 0; // Last time a message was sent to the server
 
-
-#ifdef TESTING_MAIN
-void setup()
+// === Tasks ===
+// comms (core 0)    WebSocket client, see COMMS.h
+// loopTask (core 1) this file: state machine (FSM.h), commands, telemetry;
+//                   publishes the run state for other tasks (RUN_STATE.h)
+// motion (core 1)   move scheduler, see MOTION.h
+// heating (core 1)  heater regulation, see HEATING.h
+
+/**
+ * @brief Work that must keep running while a motor move is in progress.
+ *
+ * Registered as the DRV8825 idle hook, so it runs while DRV8825_Wait()
+ * or MOTION_Wait() waits for a dispense or carriage move.
+ */
+void serviceDuringMotion()
 {
+  MOTION_Service(); // Run callbacks of moves finished on the other axis
+}
 
-  Serial.begin(115200);
-  delay(2000); // Allow USB Serial to connect
 
-  // Wi-Fi connect
-  Serial.println("Connecting to WiFi...");
-  WiFi.begin(ssid, password);
-  while (WiFi.status() != WL_CONNECTED)
+// === Moves in flight (0 = none) ===
+// States queue a move once and advance from its completion callback (or, for
+// the carriage sequences, wait for it to clear the handle), so loop() keeps
+// running (WebSocket, telemetry) while the motors move.
+static MOTION_HANDLE_t carriageMove = 0;
+static MOTION_HANDLE_t syringeMove = 0;
+static bool carriageMoveOk = false; // Result of the last carriage move
+
+/**
+ * @brief Leaves `origin` for `next` once a move queued in `origin` has finished.
+ *
+ * If the run was paused meanwhile, only the resume target is updated so the
+ * finished move is not repeated on resume.
+ */
+static void advanceAfterMove(SystemState origin, SystemState next)
+{
+  if (currentState == origin)
   {
-    delay(500);
-    Serial.print(".");
+    setState(next);
   }
-  Serial.println("\nWiFi connected. IP: " + WiFi.localIP().toString());
+  else if (currentState == SystemState::PAUSED && previousState == origin)
+  {
+    previousState = next;
+  }
+}
 
-  webSocket.begin(ServerIP, ServerPort, "/");
-  webSocket.onEvent(onWebSocketEvent); // Remove the parentheses, we're passing the function pointer
+/**
+ * @brief Carriage reached a bumper; the sequence that queued it reads the result.
+ *
+ * @param context Direction of the move (DRV8825_FORWARD / DRV8825_BACKWARD)
+ */
+static void onCarriageDone(const MOTION_EVENT_t *event, void *context)
+{
+  carriageMove = 0;
+  carriageMoveOk = MOVEMENT_Finish_Move(event, (int)(intptr_t)context); // Errors already reported
+}
 
-  Serial0.print("ESP32 MAC Address: ");
-  Serial0.println(WiFi.macAddress());
-  HEATING_Init();
-  MIXING_Init();
-  Rehydration_InitAndDisable();
-  MOVEMENT_InitAndDisable();// TEST 
+/**
+ * @brief Dispense finished; book the steps and start mixing.
+ */
+static void onDispenseDone(const MOTION_EVENT_t *event, void *)
+{
+  syringeMove = 0;
+  Rehydration_Finish_Push(event);
+  sendSyringePercentage();
+  advanceAfterMove(SystemState::REHYDRATING, SystemState::MIXING);
+}
 
-  MOVEMENT_ConfigureInterrupts();
-  REHYDRATION_ConfigureInterrupts();
-  Serial.println("[SYSTEM] Initialization complete. Starting main loop...");
-  MOVEMENT_Init();
+/**
+ * @brief Syringe is fully retracted for a refill.
+ */
+static void onRetractDone(const MOTION_EVENT_t *event, void *)
+{
+  syringeMove = 0;
+  if (!Rehydration_Finish_Retract(event))
+    return;
 
+  syringeStepCount = 0;   // Reset step counter
+  sendSyringeResetInfo(); // Notify webserver
 }
 
-void loop()
+
+// === State Handlers (rows of controlStates below) ===
+// Ticks run after every event and return how long they can sleep; states
+// waiting on a command or a move return FSM_MAX_WAIT_MS.
+
+#define TELEMETRY_PERIOD_MS 1000
+#define AUTOTUNE_POLL_MS 100 // The heating task has no completion event
+
+// Interrupted HEATING/MIXING time, restored when the run resumes
+static unsigned long pausedElapsedTime = 0;
+static unsigned long pausedAtTime = 0;
+
+/**
+ * @brief Sends `send()` once per TELEMETRY_PERIOD_MS.
+ *
+ * @return Milliseconds until the next one is due
+ */
+static uint32_t telemetry(unsigned long now, void (*send)(void))
 {
-  webSocket.loop();
-  MOVEMENT_HandleInterrupts();
-  REHYDRATION_HandleInterrupts();
+  if (now - lastSent >= TELEMETRY_PERIOD_MS)
+  {
+    send();
+    lastSent = now;
+  }
+  return TELEMETRY_PERIOD_MS - (now - lastSent);
+}
 
-  unsigned long now = millis();
-  switch (currentState)
+/**
+ * @brief Entry of PAUSED, EXTRACTING and REFILLING: saves how far the
+ *        interrupted state had got.
+ */
+static void enterHold(SystemState from)
+{
+  pausedAtTime = millis();
+  if (from == SystemState::HEATING)
   {
-  case SystemState::IDLE:
-    // Await vialSetup packet from frontend
-    if (now - lastSent >= 1000)
-    {
-      sendTemperature();
-      lastSent = now;
-    }
-    break;
+    pausedElapsedTime = millis() - heatingStartTime;
+  }
+  else if (from == SystemState::MIXING)
+  {
+    pausedElapsedTime = millis() - mixingStartTime;
+  }
+  else
+  {
+    pausedElapsedTime = 0;
+  }
+}
 
-  case SystemState::VIAL_SETUP:
+/**
+ * @brief Exit of PAUSED, EXTRACTING and REFILLING: shifts the interrupted
+ *        state's start time and remaining duration past the hold.
+ */
+static void exitHold(SystemState to)
+{
+  if (FSM_Holds_Run(to))
+    return; // Still held (e.g. PAUSED -> EXTRACTING)
 
-    if (shouldMoveForward && !movementForwardDone)
-    {
-      Serial.println("[VIAL_SETUP] Moving forward...");
-      MOVEMENT_Move_FORWARD();
-      movementForwardDone = true; // Mark forward movement as done
-    }
-    else if (shouldMoveBack && !movementBackDone)
-    {
-      Serial.println("[VIAL_SETUP] Flag down — moving backward...");
-      MOVEMENT_Move_BACKWARD();
-      movementForwardDone = true; // Reset forward movement flag
-      Serial.println("VIAL_SETUP] Ended - resuming");
-      movementBackDone = false;
-      movementForwardDone = false; // Reset both movement flag
-      shouldMoveBack = false; // Reset back movement flag
-      shouldMoveForward = false; // Reset forward movement flag
-      currentState = SystemState::WAITING; // Transition back to the previous state
-      sendCurrentState();
-    }
-    // Only send state once on entry (handled by setState)
-    break;
+  if (previousState == SystemState::HEATING)
+  {
+    heatingStartTime = millis() - pausedElapsedTime;
+    heatingDurationRemaining -= pausedElapsedTime;
+    if (heatingDurationRemaining < 0)
+      heatingDurationRemaining = 0;
+  }
+  else if (previousState == SystemState::MIXING)
+  {
+    mixingStartTime = millis() - pausedElapsedTime;
+    mixingDurationRemaining -= pausedElapsedTime;
+    if (mixingDurationRemaining < 0)
+      mixingDurationRemaining = 0;
+  }
+  pausedElapsedTime = 0;
+  pausedAtTime = 0;
+}
 
-  case SystemState::WAITING:
-    // Await parameters packet from frontend
-    // Only send state once on entry (handled by setState)
-    if (now - lastSent >= 1000)
-    {
-      sendTemperature();
-      lastSent = now;
-    }
-    break;
+static uint32_t tickTemperature(unsigned long now)
+{
+  return telemetry(now, sendTemperature);
+}
 
-  case SystemState::READY:
-    if (now - lastSent >= 1000)
-    {
-      sendTemperature();
-      lastSent = now;
-    }
-    break;
-  case SystemState::PAUSED:
-    if (now - lastSent >= 1000)
-    {
-      sendTemperature();
-      lastSent = now;
-    }
-    break;
+// === Carriage Sequences ===
+// VIAL_SETUP and EXTRACTING each run a protothread (PROTOTHREAD.h) from
+// their tick, so it keeps its place while the run is paused. The commands
+// only raise shouldMoveForward / shouldMoveBack; the sequence consumes them.
+static PT_t vialSetupSequence;
+static PT_t extractionSequence;
+
+/**
+ * @brief Queues a bumper-to-bumper carriage move for a sequence.
+ *
+ * The vials are only reachable at the front bumper until the travel is
+ * measured, so the sequences run bumper to bumper rather than to stored
+ * positions.
+ *
+ * @param direction DRV8825_FORWARD (front bumper) or DRV8825_BACKWARD (home)
+ * @return false while the carriage queue is full
+ */
+static bool queueCarriage(int direction)
+{
+  void *context = (void *)(intptr_t)direction;
+  carriageMoveOk = false;
+  carriageMove = (direction == DRV8825_FORWARD) ? MOVEMENT_Queue_FORWARD(onCarriageDone, context)
+                                                : MOVEMENT_Queue_BACKWARD(onCarriageDone, context);
+  return carriageMove != 0;
+}
 
-  case SystemState::REHYDRATING:
+/**
+ * @brief Moves the carriage out on request, waits for the user, brings it home.
+ *
+ * @param pt         The operation's protothread
+ * @param tag        Log prefix
+ * @param extraction Tell the frontend once the carriage is out
+ * @return PT_ENDED once the carriage is home, PT_EXITED if a move failed
+ */
+static PT_STATUS_t carriageSequence(PT_t *pt, const char *tag, bool extraction)
+{
+  PT_BEGIN(pt);
+
+  PT_WAIT_UNTIL(pt, shouldMoveForward && carriageMove == 0); // An abandoned run may still be moving
+  shouldMoveForward = false;
+  Serial.printf("%s Moving forward...\n", tag);
+  PT_WAIT_UNTIL(pt, queueCarriage(DRV8825_FORWARD));
+  PT_WAIT_UNTIL(pt, carriageMove == 0);
+  if (!carriageMoveOk)
+    PT_EXIT(pt);
+
+  movementForwardDone = true;
+  if (extraction)
   {
-    // Only send state once on entry (handled by setState)
-    Serial.println("[STATE] Rehydrating...");
-    if (currentCycle >= numberOfCycles)
-    {
-      Serial.println("[REHYDRATION] Final cycle already completed. Sending end packet and switching to ENDED.");
-      sendEndOfCycles();
-      currentState = SystemState::ENDED;
-      sendCurrentState(); // Notify state change to ENDED
-      break;
-    }
-    float uL_per_step = calculate_uL_per_step(syringeDiameter);
-    int stepsToMove = (int)(volumeAddedPerCycle / uL_per_step);
+    sendExtractionReady(); // Notify frontend that extraction is ready
+  }
 
-    Serial.printf("[REHYDRATION] Dispensing %.2f uL of water using a %.2f inch diameter syringe (%d steps).\n",
-                  volumeAddedPerCycle, syringeDiameter, stepsToMove);
+  PT_WAIT_UNTIL(pt, shouldMoveBack);
+  shouldMoveBack = false;
+  Serial.printf("%s Flag down — moving backward...\n", tag);
+  PT_WAIT_UNTIL(pt, queueCarriage(DRV8825_BACKWARD));
+  PT_WAIT_UNTIL(pt, carriageMove == 0);
+  if (!carriageMoveOk)
+    PT_EXIT(pt);
 
-    syringeStepCount += stepsToMove;
-    Rehydration_Push((uint32_t)volumeAddedPerCycle, syringeDiameter);
+  movementForwardDone = false;
+  PT_END(pt);
+}
 
-    sendSyringePercentage();
+/**
+ * @brief Starts a carriage sequence over when its state is entered.
+ *
+ * Coming back from a pause it carries on where it stopped. Otherwise the
+ * previous run may have been left half way (e.g. "vialSetup" "no" with the
+ * carriage out), so it restarts and drops requests nobody consumed.
+ */
+static void restartCarriageSequence(PT_t *pt, SystemState from)
+{
+  if (FSM_Holds_Run(from) && previousState == currentState)
+    return; // Resuming after a pause
 
-    currentState = SystemState::MIXING;
-    sendCurrentState();
-    break;
+  PT_INIT(pt);
+  shouldMoveForward = false;
+  shouldMoveBack = false;
+  movementForwardDone = false;
+}
+
+static void enterVialSetup(SystemState from)
+{
+  restartCarriageSequence(&vialSetupSequence, from);
+}
+
+static void enterExtracting(SystemState from)
+{
+  enterHold(from);
+  restartCarriageSequence(&extractionSequence, from);
+}
+
+static uint32_t tickVialSetup(unsigned long)
+{
+  if (carriageSequence(&vialSetupSequence, "[VIAL_SETUP]", false) == PT_ENDED)
+  {
+    Serial.println("[VIAL_SETUP] Ended - resuming");
+    setState(SystemState::WAITING);
   }
+  return FSM_MAX_WAIT_MS;
+}
 
-  case SystemState::MIXING:
+static uint32_t tickExtracting(unsigned long)
+{
+  if (carriageSequence(&extractionSequence, "[EXTRACTING]", true) == PT_ENDED)
   {
-    if (!mixingStarted)
-    {
-      Serial.println("[MIXING] Starting...");
+    Serial.println("Extraction ended — resuming");
+    setState(previousState);
+  }
+  return FSM_MAX_WAIT_MS;
+}
+
+/**
+ * @brief Queues this cycle's dispense, or ends the run after the last cycle.
+ */
+static uint32_t tickRehydrating(unsigned long)
+{
+  if (syringeMove != 0)
+  {
+    return FSM_MAX_WAIT_MS; // Dispense in progress; onDispenseDone() moves on to MIXING
+  }
+
+  Serial.println("[STATE] Rehydrating...");
+  if (currentCycle >= numberOfCycles)
+  {
+    Serial.println("[REHYDRATION] Final cycle already completed. Sending end packet and switching to ENDED.");
+    sendEndOfCycles();
+    setState(SystemState::ENDED);
+    return 0;
+  }
+  float uL_per_step = calculate_uL_per_step(syringeDiameter);
+  int stepsToMove = (int)(volumeAddedPerCycle / uL_per_step);
+
+  Serial.printf("[REHYDRATION] Dispensing %.2f uL of water using a %.2f inch diameter syringe (%d steps).\n",
+                volumeAddedPerCycle, syringeDiameter, stepsToMove);
 
-      // Decide how long to mix based on whether we're recovering
-      unsigned long mixTime = heatingStarted ? mixingDurationRemaining : (durationOfMixing * 1000);
-      mixingStartTime = millis();
-      mixingDurationRemaining = mixTime;
-      mixingStarted = true;
+  // syringeStepCount is updated with the exact steps sent in onDispenseDone()
+  syringeMove = Rehydration_Queue_Push((uint32_t)volumeAddedPerCycle, syringeDiameter,
+                                       onDispenseDone, NULL);
+  return FSM_MAX_WAIT_MS;
+}
 
-      // Turn on motors for the selected sample zones
-      for (int i = 0; i < sampleZoneCount; i++)
+/**
+ * @brief Runs the zone motors for the mixing time.
+ */
+static uint32_t tickMixing(unsigned long now)
+{
+  if (!mixingStarted)
+  {
+    Serial.println("[MIXING] Starting...");
+
+    // Decide how long to mix based on whether we're recovering
+    unsigned long mixTime = heatingStarted ? mixingDurationRemaining : (durationOfMixing * 1000);
+    mixingStartTime = millis();
+    mixingDurationRemaining = mixTime;
+    mixingStarted = true;
+
+    // Turn on motors for the selected sample zones, all in the same instant
+    uint8_t zonePins[3];
+    int zonePinCount = 0;
+    for (int i = 0; i < sampleZoneCount; i++)
+    {
+      int zone = sampleZonesArray[i];
+      int pin = (zone == 1) ? 11 : (zone == 2) ? 12
+                               : (zone == 3)   ? 13
+                                               : -1;
+      if (pin != -1 && zonePinCount < 3)
       {
-        int zone = sampleZonesArray[i];
-        int pin = (zone == 1) ? 11 : (zone == 2) ? 12
-                                 : (zone == 3)   ? 13
-                                                 : -1;
-        if (pin != -1)
-        {
-          Serial.printf("[MIXING] Motor ON for zone %d (GPIO %d)\n", zone, pin);
-          MIXING_Motor_OnPin(pin);
-        }
+        Serial.printf("[MIXING] Motor ON for zone %d (GPIO %d)\n", zone, pin);
+        zonePins[zonePinCount++] = (uint8_t)pin;
       }
     }
+    MIXING_Motors_OnPins(zonePins, zonePinCount);
+  }
 
-    // Send progress update every second
-    if (now - lastSent >= 1000)
-    {
-      sendMixingProgress();
-      lastSent = now;
-    }
+  uint32_t next = telemetry(now, sendMixingProgress);
 
-    // Check if the mixing duration has passed
-    if (millis() - mixingStartTime >= mixingDurationRemaining)
-    {
-      Serial.println("[MIXING] Done. Turning off motors.");
-      MIXING_AllMotors_Off();
-      mixingStarted = false;
-      currentState = SystemState::HEATING;
-      sendCurrentState();
+  // Check if the mixing duration has passed
+  unsigned long elapsed = millis() - mixingStartTime;
+  if (elapsed >= mixingDurationRemaining)
+  {
+    Serial.println("[MIXING] Done. Turning off motors.");
+    MIXING_AllMotors_Off();
+    mixingStarted = false;
+    setState(SystemState::HEATING);
+    return 0;
+  }
+  uint32_t left = (uint32_t)(mixingDurationRemaining - elapsed);
+  return (left < next) ? left : next;
+}
+
+/**
+ * @brief Holds the pad at the setpoint for the heating time.
+ */
+static uint32_t tickHeating(unsigned long now)
+{
+  if (!heatingStarted)
+  {
+    Serial.printf("[HEATING] Starting... durationOfHeating = %.2f\n", durationOfHeating);
+    unsigned long heatTime = heatingProgressPercent > 0
+                                 ? (unsigned long)((1.0 - (heatingProgressPercent / 100.0)) * durationOfHeating * 1000)
+                                 : (unsigned long)(durationOfHeating * 1000);
+
+    // If resuming from pause, use heatingDurationRemaining if set
+    if (heatingDurationRemaining > 0 && heatingDurationRemaining < heatTime) {
+      heatTime = heatingDurationRemaining;
     }
-    break;
+
+    heatingStartTime = millis();
+    heatingDurationRemaining = heatTime;
+    heatingStarted = true;
   }
 
-  case SystemState::HEATING:
+  // Command the setpoint (picks up new parameters); the heating task regulates
+  HEATING_Set_Temp((int)desiredHeatingTemperature);
+
+  // Send temperature and progress every second
+  if (now - lastSent >= TELEMETRY_PERIOD_MS)
   {
-    if (!heatingStarted)
-    {
-      Serial.printf("[HEATING] Starting... durationOfHeating = %.2f\n", durationOfHeating);
-      unsigned long heatTime = heatingProgressPercent > 0
-                                   ? (unsigned long)((1.0 - (heatingProgressPercent / 100.0)) * durationOfHeating * 1000)
-                                   : (unsigned long)(durationOfHeating * 1000);
-
-      // If resuming from pause, use heatingDurationRemaining if set
-      if (heatingDurationRemaining > 0 && heatingDurationRemaining < heatTime) {
-        heatTime = heatingDurationRemaining;
-      }
+    sendTemperature();
+    sendHeatingProgress();
+    lastSent = now;
+  }
+  uint32_t next = TELEMETRY_PERIOD_MS - (now - lastSent);
 
-      heatingStartTime = millis();
-      heatingDurationRemaining = heatTime;
-      heatingStarted = true;
-    }
+  // Check if heating is complete
+  unsigned long elapsed = millis() - heatingStartTime;
+  if (elapsed >= heatingDurationRemaining)
+  {
+    Serial.println("[HEATING] Done. Turning off heater.");
+    HEATING_Off();
+    heatingStarted = false;
+    completedCycles++;
+    currentCycle++;
+    sendCycleProgress();
+    setState(SystemState::REHYDRATING);
+    return 0;
+  }
+  uint32_t left = (uint32_t)(heatingDurationRemaining - elapsed);
+  return (left < next) ? left : next;
+}
 
-    // Control the heater
-    HEATING_Set_Temp((int)desiredHeatingTemperature);
+/**
+ * @brief Exit of HEATING: stops the heater if the run is interrupted or ended.
+ */
+static void exitHeating(SystemState to)
+{
+  if (FSM_Holds_Run(to) || to == SystemState::ENDED)
+  {
+    HEATING_Off();
+    heatingStarted = false;
+    Serial.println("[HEATING] Heater stopped due to state transition");
+  }
+}
 
-    // Send telemetry every second
-    if (now - lastSent >= 1000)
-    {
-      sendTemperature();
+/**
+ * @brief Exit of MIXING: stops the motors if the run is interrupted or ended.
+ */
+static void exitMixing(SystemState to)
+{
+  if (FSM_Holds_Run(to) || to == SystemState::ENDED)
+  {
+    MIXING_AllMotors_Off();
+    mixingStarted = false;
+    Serial.println("[PAUSED] Motors stopped due to state transition");
+  }
+}
 
-      // Send progress
-      unsigned long elapsed = millis() - heatingStartTime;
-      float percentDone = ((float)elapsed / heatingDurationRemaining) * 100.0;
-      if (percentDone > 100.0)
-        percentDone = 100.0;
+static uint32_t tickRefilling(unsigned long)
+{
+  if (!refillingStarted)
+  {
+    Serial.println("[STATE] REFILLING: Moving back until back bumper is hit");
+    syringeMove = Rehydration_Queue_BackUntilBumper(onRetractDone, NULL); // Retract fully
+    refillingStarted = (syringeMove != 0);
+    // Stay in REFILLING state until we receive a "no" command
+    // The state transition will be handled by handleStateCommand when
+    // it receives "refill":"no" from the frontend
+  }
+  return FSM_MAX_WAIT_MS;
+}
 
-      ArduinoJson::JsonDocument doc; // auto-resizing with latest versions
-      sendHeatingProgress();
+static uint32_t tickLogging(unsigned long)
+{
+  Serial.println("Logging data...");
+  setState(previousState);
+  return 0;
+}
 
-      lastSent = now;
-    }
+static uint32_t tickEnded(unsigned long)
+{
+  completedCycles = 0;
+  currentCycle = 0;
+  setState(SystemState::VIAL_SETUP);
+  return 0;
+}
 
-    // Check if heating is complete
-    if (millis() - heatingStartTime >= heatingDurationRemaining)
-    {
-      Serial.println("[HEATING] Done. Turning off heater.");
-      HEATING_Off();
-      heatingStarted = false;
-      completedCycles++;
-      currentCycle++;
-      sendCycleProgress();
-      currentState = SystemState::REHYDRATING;
-      sendCurrentState();
-    }
+/**
+ * @brief Reports autotune progress, then the result once the heating task
+ *        has finished it.
+ */
+static uint32_t tickAutotuning(unsigned long now)
+{
+  HEATING_AUTOTUNE_STATUS_t status = HEATING_Autotune_Status();
+  if (status == HEATING_AUTOTUNE_RUNNING)
+  {
+    uint32_t next = telemetry(now, sendAutotuneProgress);
+    return (next < AUTOTUNE_POLL_MS) ? next : AUTOTUNE_POLL_MS;
+  }
 
-    break;
+  // Done, failed or cancelled: gains are only kept from a completed tune
+  if (status == HEATING_AUTOTUNE_DONE)
+  {
+    HEATING_Save_PID();
   }
+  HEATING_Off();
+  sendAutotuneResult();
+  setState(previousState == SystemState::READY ? SystemState::READY : SystemState::WAITING);
+  return 0;
+}
 
-  case SystemState::REFILLING:
-    if (!refillingStarted)
-    {
-      Serial.println("[STATE] REFILLING: Moving back until back bumper is hit");
-      Rehydration_BackUntilBumper(); // Retract fully
-      syringeStepCount = 0;          // Reset step counter
-      sendSyringeResetInfo();        // Notify webserver
-      refillingStarted = true;
-      // Stay in REFILLING state until we receive a "no" command
-      // The state transition will be handled by handleStateCommand when
-      // it receives "refill":"no" from the frontend
-    }
-    break;
+/**
+ * @brief Exit of AUTOTUNING: never leave the relay switching unattended.
+ */
+static void exitAutotuning(SystemState to)
+{
+  if (to != SystemState::AUTOTUNING)
+  {
+    HEATING_Autotune_Cancel();
+  }
+}
 
-  case SystemState::EXTRACTING:
-    if (shouldMoveForward && !movementForwardDone)
-    {
-      Serial.println("[EXTRACTING] Moving forward...");
-      MOVEMENT_Move_FORWARD();
-      movementForwardDone = true; // Mark forward movement as done
-      sendExtractionReady(); // Notify frontend that extraction is ready
-    }
-    else if (shouldMoveBack && !movementBackDone)
-    {
-      Serial.println("[EXTRACTING] Flag down — moving backward...");
-      MOVEMENT_Move_BACKWARD();
-      movementForwardDone = true; // Reset forward movement flag
-      Serial.println("Extraction ended — resuming");
-      movementBackDone = false;
-      movementForwardDone = false; // Reset both movement flag
-      shouldMoveBack = false; // Reset back movement flag
-      shouldMoveForward = false; // Reset forward movement flag
-      currentState = previousState; // Transition back to the previous state
-      sendCurrentState();
-    }
-    break;
-
-  case SystemState::LOGGING:
-    Serial.println("Logging data...");
-    currentState = previousState;
-    sendCurrentState();
-    break;
-
-  case SystemState::ENDED:
-    completedCycles = 0;
-    currentCycle = 0;
-    currentState = SystemState::VIAL_SETUP;
-    sendCurrentState();
-    break;
-
-  case SystemState::ERROR:
-    Serial.println("System error — awaiting reset or external command.");
-    break;
+static void enterError(SystemState)
+{
+  Serial.println("System error — awaiting reset or external command.");
+}
+
+// One row per SystemState, in enum order
+static const FSM_STATE_t controlStates[FSM_STATE_COUNT] = {
+    // state                   name           holdsRun entry            exit            tick
+    {SystemState::VIAL_SETUP,  "VIAL_SETUP",  false,   enterVialSetup,  NULL,           tickVialSetup},
+    {SystemState::WAITING,     "WAITING",     false,   NULL,            NULL,           tickTemperature},
+    {SystemState::IDLE,        "IDLE",        false,   NULL,            NULL,           tickTemperature},
+    {SystemState::READY,       "READY",       false,   NULL,            NULL,           tickTemperature},
+    {SystemState::REHYDRATING, "REHYDRATING", false,   NULL,            NULL,           tickRehydrating},
+    {SystemState::HEATING,     "HEATING",     false,   NULL,            exitHeating,    tickHeating},
+    {SystemState::MIXING,      "MIXING",      false,   NULL,            exitMixing,     tickMixing},
+    {SystemState::REFILLING,   "REFILLING",   true,    enterHold,       exitHold,       tickRefilling},
+    {SystemState::EXTRACTING,  "EXTRACTING",  true,    enterExtracting, exitHold,       tickExtracting},
+    {SystemState::LOGGING,     "LOGGING",     false,   NULL,            NULL,           tickLogging},
+    {SystemState::PAUSED,      "PAUSED",      true,    enterHold,       exitHold,       tickTemperature},
+    {SystemState::ENDED,       "ENDED",       false,   NULL,            NULL,           tickEnded},
+    {SystemState::AUTOTUNING,  "AUTOTUNING",  false,   NULL,            exitAutotuning, tickAutotuning},
+    {SystemState::ERROR,       "ERROR",       false,   enterError,      NULL,           NULL},
+};
+
+
+#ifdef TESTING_MAIN
+/**
+ * @brief FSM_EVENT_FRAME: handles every frame the comms task has queued.
+ */
+static void receiveFrames()
+{
+  static COMMS_FRAME_t frame;
+  while (COMMS_Receive(&frame, 0))
+    onWebSocketMessage(frame.text, frame.length);
+}
+
+static void postFrameEvent() { FSM_Post(FSM_EVENT_FRAME); }
+static void postMotionEvent() { FSM_Post(FSM_EVENT_MOTION); }
+
+void setup()
+{
+
+  Serial.begin(115200);
+  delay(2000); // Allow USB Serial to connect
+
+  // Event sources are hooked up before they start
+  bool fsmReady = FSM_Init(controlStates);
+  RUN_STATE_Init(); // Before anything can change state (boot homing may raise ERROR)
+  FSM_Set_Handler(FSM_EVENT_FRAME, receiveFrames);
+  FSM_Set_Handler(FSM_EVENT_MOTION, MOTION_Service);
+  COMMS_Set_Receive_Hook(postFrameEvent);
+  MOTION_Set_Done_Hook(postMotionEvent);
+
+  // Wi-Fi connect
+  Serial.println("Connecting to WiFi...");
+  WiFi.begin(ssid, password);
+  while (WiFi.status() != WL_CONNECTED)
+  {
+    delay(500);
+    Serial.print(".");
   }
-  delay(10);
+  Serial.println("\nWiFi connected. IP: " + WiFi.localIP().toString());
+
+  COMMS_Init(ServerIP, ServerPort, "/");
+
+  Serial0.print("ESP32 MAC Address: ");
+  Serial0.println(WiFi.macAddress());
+  HEATING_Init();
+  MIXING_Init();
+  DRV8825_Set_Idle_Hook(serviceDuringMotion); // Keep motion callbacks running during moves
+  Rehydration_InitAndDisable();
+  MOVEMENT_InitAndDisable();// TEST 
+
+  MOVEMENT_ConfigureInterrupts();
+  REHYDRATION_ConfigureInterrupts();
+  if (!fsmReady)
+  {
+    // Stay in ERROR: no homing, nothing will run
+    setState(SystemState::ERROR);
+    sendSystemError(ERROR_STATE_TABLE);
+    return;
+  }
+  Serial.println("[SYSTEM] Initialization complete. Starting main loop...");
+  MOVEMENT_Init();
+
+}
+
+void loop()
+{
+  MOVEMENT_HandleInterrupts();
+  REHYDRATION_HandleInterrupts();
+  FSM_Run(); // Sleeps until a frame, a finished move or the state's timer
+  RUN_STATE_Publish();
 }
 
 #endif // TESTING_MAIN
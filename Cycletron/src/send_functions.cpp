@@ -1,9 +1,11 @@
 #include <ArduinoJson.h>
 #include <WebSocketsClient.h>
+#include "COMMS.h"
 #include "HEATING.h"
 #include "globals.h"
 #include "send_functions.h"
 #include "REHYDRATION.h"
+#include "RUN_STATE.h"
 #include "state_websocket.h"
 
 
@@ -14,26 +16,28 @@ void sendHeartbeat()
   doc["value"] = 1;
   char buffer[64];
   serializeJson(doc, buffer);
-  webSocket.sendTXT(buffer);
+  COMMS_Send(buffer);
   Serial.printf("[%d] Sent heartbeat packet to frontend.\n", static_cast<int>(currentState));
 }
 
 void sendTemperature()
 {
-  float temp = HEATING_Measure_Temp_Avg();
+  float temp = HEATING_Estimate_Temp();
   ArduinoJson::JsonDocument doc;
   doc["type"] = "temperature";
   doc["value"] = temp;
 
   char buffer[100];
   serializeJson(doc, buffer);
-  webSocket.sendTXT(buffer);
+  COMMS_Send(buffer);
   Serial.printf("[WS] Sent temp: %.2f \u00b0C\n", temp);
 }
 
 void sendSyringePercentage()
 {
-  float percentUsed = ((float)syringeStepCount / (float)MAX_SYRINGE_STEPS * 100.0);
+  RUN_STATE_t run;
+  RUN_STATE_Read(&run);
+  float percentUsed = ((float)run.syringeStepCount / (float)MAX_SYRINGE_STEPS * 100.0);
 
   ArduinoJson::JsonDocument doc;
   doc["type"] = "syringePercentage";
@@ -41,14 +45,16 @@ void sendSyringePercentage()
 
   char buffer[100];
   serializeJson(doc, buffer);
-  webSocket.sendTXT(buffer);
+  COMMS_Send(buffer);
   Serial.printf("[WS] Sent syringe percentage remaining: %.2f%%\n", percentUsed);
 }
 
 void sendHeatingProgress()
 {
-  unsigned long elapsed = millis() - heatingStartTime;
-  float percentDone = ((float)elapsed / (durationOfHeating * 1000.0)) * 100.0;
+  RUN_STATE_t run;
+  RUN_STATE_Read(&run);
+  unsigned long elapsed = millis() - run.heatingStartTime;
+  float percentDone = ((float)elapsed / (run.durationOfHeating * 1000.0)) * 100.0;
 
   if (percentDone > 100.0)
     percentDone = 100.0;
@@ -59,14 +65,16 @@ void sendHeatingProgress()
 
   char buffer[100];
   serializeJson(doc, buffer);
-  webSocket.sendTXT(buffer);
+  COMMS_Send(buffer);
   Serial.printf("[WS] Sent heating progress: %.2f%%\n", percentDone);
 }
 
 void sendMixingProgress()
 {
-  unsigned long elapsed = millis() - mixingStartTime;
-  float percentDone = ((float)elapsed / (durationOfMixing * 1000.0)) * 100.0;
+  RUN_STATE_t run;
+  RUN_STATE_Read(&run);
+  unsigned long elapsed = millis() - run.mixingStartTime;
+  float percentDone = ((float)elapsed / (run.durationOfMixing * 1000.0)) * 100.0;
 
   if (percentDone > 100.0)
     percentDone = 100.0;
@@ -77,14 +85,16 @@ void sendMixingProgress()
 
   char buffer[100];
   serializeJson(doc, buffer);
-  webSocket.sendTXT(buffer);
+  COMMS_Send(buffer);
   Serial.printf("[WS] Sent mixing progress: %.2f%%\n", percentDone);
 }
 
 void sendCycleProgress()
 {
-  float percentDone = (numberOfCycles > 0)
-                          ? ((float)completedCycles / (float)numberOfCycles) * 100.0
+  RUN_STATE_t run;
+  RUN_STATE_Read(&run);
+  float percentDone = (run.numberOfCycles > 0)
+                          ? ((float)run.completedCycles / (float)run.numberOfCycles) * 100.0
                           : 0.0;
 
   if (percentDone > 100.0)
@@ -92,15 +102,15 @@ void sendCycleProgress()
 
   ArduinoJson::JsonDocument doc;
   doc["type"] = "cycleProgress";
-  doc["completed"] = completedCycles;
-  doc["total"] = numberOfCycles;
+  doc["completed"] = run.completedCycles;
+  doc["total"] = run.numberOfCycles;
   doc["percent"] = percentDone;
 
   char buffer[100];
   serializeJson(doc, buffer);
-  webSocket.sendTXT(buffer);
+  COMMS_Send(buffer);
   Serial.printf("[WS] Sent cycle progress: %d/%d (%.2f%%)\n",
-                completedCycles, numberOfCycles, percentDone);
+                run.completedCycles, run.numberOfCycles, percentDone);
 }
 
 void sendEndOfCycles()
@@ -111,23 +121,67 @@ void sendEndOfCycles()
 
   char buffer[100];
   serializeJson(doc, buffer);
-  webSocket.sendTXT(buffer);
+  COMMS_Send(buffer);
   Serial.println("[WS] Sent end of cycles packet to frontend.");
 }
 
 void sendSyringeResetInfo()
 {
+  RUN_STATE_t run;
+  RUN_STATE_Read(&run);
   ArduinoJson::JsonDocument doc;
   doc["type"] = "syringeReset";
-  doc["steps"] = syringeStepCount;
+  doc["steps"] = run.syringeStepCount;
 
   String message;
   serializeJson(doc, message);
-  webSocket.sendTXT(message);
+  COMMS_Send(message.c_str());
 
   Serial.println("[WS] Sent syringe reset info");
 }
 
+void sendAutotuneProgress()
+{
+  const HEATING_AUTOTUNE_t *tune = HEATING_Autotune_Get();
+  float percentDone = (tune->totalCycles > 0) ? ((float)tune->cycles / (float)tune->totalCycles) * 100.0 : 0.0;
+
+  ArduinoJson::JsonDocument doc;
+  doc["type"] = "autotuneProgress";
+  doc["cycle"] = tune->cycles;
+  doc["total"] = tune->totalCycles;
+  doc["percent"] = percentDone;
+  doc["temperature"] = HEATING_Estimate_Temp();
+  doc["amplitude"] = tune->amplitude;
+
+  char buffer[160];
+  serializeJson(doc, buffer);
+  COMMS_Send(buffer);
+  Serial.printf("[WS] Sent autotune progress: %d/%d cycles\n", tune->cycles, tune->totalCycles);
+}
+
+void sendAutotuneResult()
+{
+  const HEATING_AUTOTUNE_t *tune = HEATING_Autotune_Get();
+  const char *status = (tune->status == HEATING_AUTOTUNE_DONE) ? "done"
+                       : (tune->status == HEATING_AUTOTUNE_FAILED) ? "failed"
+                                                                   : "cancelled";
+
+  ArduinoJson::JsonDocument doc;
+  doc["type"] = "autotuneResult";
+  doc["status"] = status;
+  doc["setpoint"] = tune->setpoint;
+  doc["ku"] = tune->ku;
+  doc["tu"] = tune->tu;
+  doc["kp"] = tune->pid.kp;
+  doc["ki"] = tune->pid.ki;
+  doc["kd"] = tune->pid.kd;
+
+  char buffer[200];
+  serializeJson(doc, buffer);
+  COMMS_Send(buffer);
+  Serial.printf("[WS] Sent autotune result: %s\n", status);
+}
+
 void sendExtractionReady() 
 {
     ArduinoJson::JsonDocument doc;
@@ -136,14 +190,16 @@ void sendExtractionReady()
 
     char buffer[100];
     serializeJson(doc, buffer);
-    webSocket.sendTXT(buffer);
+    COMMS_Send(buffer);
     Serial.println("[WS] Sent extraction ready notification");
 }
 
 void sendCurrentState()
 {
+  RUN_STATE_t run;
+  RUN_STATE_Read(&run);
   const char *stateStr;
-  switch (currentState)
+  switch (run.state)
   {
   case SystemState::VIAL_SETUP:
     stateStr = "VIAL_SETUP";
@@ -181,6 +237,9 @@ void sendCurrentState()
   case SystemState::ENDED:
     stateStr = "ENDED";
     break;
+  case SystemState::AUTOTUNING:
+    stateStr = "AUTOTUNING";
+    break;
   case SystemState::ERROR:
     stateStr = "ERROR";
     break;
@@ -195,18 +254,20 @@ void sendCurrentState()
 
   char buffer[100];
   serializeJson(doc, buffer);
-  webSocket.sendTXT(buffer);
+  COMMS_Send(buffer);
   Serial.printf("[WS] Sent current state: %s\n", stateStr);
 }
 
 // Add this function to send a recovery packet to the server
 void sendRecoveryPacketToServer()
 {
+  RUN_STATE_t run;
+  RUN_STATE_Read(&run);
   ArduinoJson::JsonDocument doc;
   doc["type"] = "espRecoveryState";
   JsonObject data = doc["data"].to<JsonObject>();
   // Save current state and all relevant parameters
-  switch (currentState)
+  switch (run.state)
   {
   case SystemState::IDLE:
     data["currentState"] = "IDLE";
@@ -238,6 +299,9 @@ void sendRecoveryPacketToServer()
   case SystemState::ENDED:
     data["currentState"] = "ENDED";
     break;
+  case SystemState::AUTOTUNING:
+    data["currentState"] = "AUTOTUNING";
+    break;
   case SystemState::ERROR:
     data["currentState"] = "ERROR";
     break;
@@ -246,30 +310,30 @@ void sendRecoveryPacketToServer()
     break;
   }
   JsonObject parameters = data["parameters"].to<JsonObject>();
-  parameters["volumeAddedPerCycle"] = volumeAddedPerCycle;
-  parameters["syringeDiameter"] = syringeDiameter;
-  parameters["desiredHeatingTemperature"] = desiredHeatingTemperature;
-  parameters["durationOfHeating"] = durationOfHeating;
-  parameters["durationOfMixing"] = durationOfMixing;
-  parameters["numberOfCycles"] = numberOfCycles;
-  parameters["syringeStepCount"] = syringeStepCount;
-  parameters["heatingStartTime"] = heatingStartTime;
-  parameters["heatingStarted"] = heatingStarted;
-  parameters["mixingStartTime"] = mixingStartTime;
-  parameters["mixingStarted"] = mixingStarted;
-  parameters["completedCycles"] = completedCycles;
-  parameters["currentCycle"] = currentCycle;
-  parameters["heatingProgress"] = heatingProgressPercent;
-  parameters["mixingProgress"] = mixingProgressPercent;
+  parameters["volumeAddedPerCycle"] = run.volumeAddedPerCycle;
+  parameters["syringeDiameter"] = run.syringeDiameter;
+  parameters["desiredHeatingTemperature"] = run.desiredHeatingTemperature;
+  parameters["durationOfHeating"] = run.durationOfHeating;
+  parameters["durationOfMixing"] = run.durationOfMixing;
+  parameters["numberOfCycles"] = run.numberOfCycles;
+  parameters["syringeStepCount"] = run.syringeStepCount;
+  parameters["heatingStartTime"] = run.heatingStartTime;
+  parameters["heatingStarted"] = run.heatingStarted;
+  parameters["mixingStartTime"] = run.mixingStartTime;
+  parameters["mixingStarted"] = run.mixingStarted;
+  parameters["completedCycles"] = run.completedCycles;
+  parameters["currentCycle"] = run.currentCycle;
+  parameters["heatingProgress"] = run.heatingProgressPercent;
+  parameters["mixingProgress"] = run.mixingProgressPercent;
   JsonArray zones = parameters["sampleZonesToMix"].to<JsonArray>();
-  for (int i = 0; i < sampleZoneCount; i++)
+  for (int i = 0; i < run.sampleZoneCount; i++)
   {
-    zones.add(sampleZonesArray[i]);
+    zones.add(run.sampleZones[i]);
   }
   // Send to server
   String message;
   serializeJson(doc, message);
-  webSocket.sendTXT(message);
+  COMMS_Send(message.c_str());
   Serial.println("[WS] Sent ESP recovery packet to server");
 }
 
@@ -301,17 +365,34 @@ const char* systemErrorTypeToString(SystemErrorType errorType) {
             return "Syringe step count would exceed safe range";
         case ERROR_DRV8825_FAULT:
             return "DRV8825 fault pin is active! Check wiring or wall power for the DRV8825s.";
+        case ERROR_MOVEMENT_LOST_STEPS:
+            return "Carriage lost steps: bumper position does not match step count";
+        case ERROR_MOTION_RESULT_LOST:
+            return "Motion result lost: motor position is unknown";
+        case ERROR_STATE_TABLE:
+            return "Firmware state table is invalid";
         // Add more cases as needed
         default:
             return "Unknown system error";
     }
 }
 
+void sendMotorFault(const char *axis, uint32_t step) {
+    StaticJsonDocument<256> doc;
+    doc["type"] = "system_error";
+    doc["message"] = systemErrorTypeToString(ERROR_DRV8825_FAULT);
+    doc["axis"] = axis;
+    doc["step"] = step;
+    String json;
+    serializeJson(doc, json);
+    COMMS_Send(json.c_str());
+}
+
 void sendSystemError(SystemErrorType errorType) {
     StaticJsonDocument<256> doc;
     doc["type"] = "system_error";
     doc["message"] = systemErrorTypeToString(errorType);
     String json;
     serializeJson(doc, json);
-    webSocket.sendTXT(json);
+    COMMS_Send(json.c_str());
 }
\ No newline at end of file
@@ -81,6 +81,21 @@ void sendSyringeResetInfo();
  */
 void sendCurrentState();
 
+/**
+ * @brief Sends heater autotune progress to frontend
+ * 
+ * Reports oscillations completed, current temperature and amplitude
+ */
+void sendAutotuneProgress();
+
+/**
+ * @brief Sends heater autotune outcome to frontend
+ * 
+ * Reports done/failed/cancelled with the ultimate gain and period and
+ * the PID gains that were applied
+ */
+void sendAutotuneResult();
+
 /**
  * @brief Sends extraction ready notification to frontend
  * 
@@ -98,4 +113,15 @@ void sendExtractionReady();
  */
 void sendSystemError(SystemErrorType errorType);
 
+/**
+ * @brief Sends a DRV8825 fault notification to frontend
+ * 
+ * Same packet as sendSystemError(ERROR_DRV8825_FAULT), plus the axis that
+ * faulted and the step the move was aborted at
+ * 
+ * @param axis Name of the faulted axis ("carriage", "syringe")
+ * @param step Steps sent before the fault stopped the move
+ */
+void sendMotorFault(const char *axis, uint32_t step);
+
 #endif // SEND_FUNCTIONS_H
@@ -8,26 +8,16 @@
 extern WebSocketsClient webSocket;
 
 /**
- * @brief Updates the system state and handles state transitions
+ * @brief Handles one message received from the server
  * 
- * Manages motor states, timing, and pause/resume functionality
- * during state transitions. Also sends state updates to the client.
+ * Processes incoming JSON messages for state changes, parameter
+ * updates, and system recovery. Call from the state machine's task
+ * with the frames from COMMS_Receive().
  * 
- * @param newState The state to transition to
- */
-void setState(SystemState newState);
-
-/**
- * @brief Handles WebSocket events and incoming messages
- * 
- * Processes connection events and incoming JSON messages for
- * state changes, parameter updates, and system recovery.
- * 
- * @param type The type of WebSocket event
- * @param payload The message data
+ * @param payload The message text (NUL-terminated)
  * @param length Length of the payload
  */
-void onWebSocketEvent(WStype_t type, uint8_t *payload, size_t length);
+void onWebSocketMessage(const char *payload, size_t length);
 
 /**
  * @brief Hash function for string literals